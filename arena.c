@@ -0,0 +1,87 @@
+/**
+ * @file arena.c
+ * @brief Bump-pointer allocation arena.
+ *
+ * Each block is a single `malloc` holding a header followed by its payload.
+ * Allocations are carved from the front block; when it is full, a new block
+ * is pushed onto the list.
+ *
+ * Dependencies:
+ * - `arena.h`: Declares the interface for this functionality.
+ */
+#include "arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+struct ArenaBlock {
+    ArenaBlock *next;
+    size_t capacity;  // Usable bytes in `data`
+    size_t used;      // Bytes handed out from `data`
+    _Alignas(ARENA_ALIGNMENT) unsigned char data[];
+};
+
+/**
+ * @brief Initializes an empty arena.
+ *
+ * @param arena Pointer to the arena to be initialized.
+ * @param block_size Usable size of each block, or 0 for `DEFAULT_ARENA_BLOCK_SIZE`.
+ */
+void init_arena(Arena *arena, size_t block_size) {
+    arena->blocks = NULL;
+    arena->block_size = block_size > 0 ? block_size : DEFAULT_ARENA_BLOCK_SIZE;
+    arena->allocated = 0;
+} // init_arena
+
+/**
+ * @brief Allocates uninitialized memory from the arena.
+ *
+ * @param arena Pointer to the arena.
+ * @param size Number of bytes requested.
+ * @return Pointer to the memory, or NULL on failure.
+ */
+void *arena_alloc(Arena *arena, size_t size) {
+    size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    if (size == 0) size = ARENA_ALIGNMENT;
+
+    ArenaBlock *block = arena->blocks;
+    if (!block || block->capacity - block->used < size) {
+        size_t capacity = size > arena->block_size ? size : arena->block_size;
+        block = malloc(sizeof(ArenaBlock) + capacity);
+        if (!block) {
+            perror("Failed to allocate arena block");
+            return NULL;
+        }
+        block->capacity = capacity;
+        block->used = 0;
+
+        // Oversized blocks go behind the current one so it keeps serving small requests
+        if (capacity > arena->block_size && arena->blocks) {
+            block->next = arena->blocks->next;
+            arena->blocks->next = block;
+        } else {
+            block->next = arena->blocks;
+            arena->blocks = block;
+        }
+    }
+
+    void *memory = block->data + block->used;
+    block->used += size;
+    arena->allocated += size;
+    return memory;
+} // arena_alloc
+
+/**
+ * @brief Frees every block of the arena, invalidating all its allocations.
+ *
+ * @param arena Pointer to the arena to be freed.
+ */
+void free_arena(Arena *arena) {
+    ArenaBlock *block = arena->blocks;
+    while (block) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->blocks = NULL;
+    arena->allocated = 0;
+} // free_arena
@@ -0,0 +1,40 @@
+/**
+ * @file arena.h
+ * @brief Header file for the bump-pointer allocation arena.
+ *
+ * Declares an arena that hands out memory from large blocks and releases it all
+ * at once, so the buffers of a run need no individual `free` calls.
+ *
+ * Notes:
+ * - Allocations are aligned to `ARENA_ALIGNMENT` bytes.
+ * - Requests larger than the block size get a block of their own.
+ * - Memory is only returned by `free_arena`.
+ */
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_ALIGNMENT 16                  // Alignment of every allocation
+#define DEFAULT_ARENA_BLOCK_SIZE (1 << 20)  // Block size used when none is given
+
+/**
+ * @brief Block of arena memory; blocks form a singly linked list.
+ */
+typedef struct ArenaBlock ArenaBlock;
+
+/**
+ * @brief Arena that owns every block allocated through it.
+ */
+typedef struct {
+    ArenaBlock *blocks;  ///< Most recently allocated block first
+    size_t block_size;   ///< Usable size of a regular block
+    size_t allocated;    ///< Bytes handed out so far
+} Arena;
+
+// Function Declarations
+void init_arena(Arena *arena, size_t block_size);
+void *arena_alloc(Arena *arena, size_t size);
+void free_arena(Arena *arena);
+
+#endif // ARENA_H
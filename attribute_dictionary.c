@@ -0,0 +1,170 @@
+/**
+ * @file attribute_dictionary.c
+ * @brief String-interning table for dataset attributes.
+ *
+ * Stores each distinct attribute once, in a single string pool, and hands out
+ * dense integer ids. Lookups use open addressing with linear probing over a
+ * power-of-two table that is doubled whenever it becomes half full.
+ *
+ * Dependencies:
+ * - `attribute_dictionary.h`: Declares the interface for this functionality.
+ */
+#include "attribute_dictionary.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_BUCKETS 64        // Initial size of the hash table
+#define INITIAL_STRINGS_SIZE 1024 // Initial size of the string pool, in bytes
+
+/**
+ * @brief FNV-1a hash of a NUL-terminated string.
+ */
+static uint32_t hash_attribute(const char *name) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash;
+} // hash_attribute
+
+/**
+ * @brief Doubles the hash table and reinserts every interned id.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+static int grow_buckets(AttributeDictionary *dictionary) {
+    int bucket_count = dictionary->bucket_count ? dictionary->bucket_count * 2 : INITIAL_BUCKETS;
+    int *buckets = malloc(bucket_count * sizeof(int));
+    if (!buckets) {
+        perror("Failed to allocate memory for attribute dictionary");
+        return 0;
+    }
+    for (int b = 0; b < bucket_count; b++) buckets[b] = -1;
+
+    for (int id = 0; id < dictionary->count; id++) {
+        uint32_t b = hash_attribute(attribute_name(dictionary, id)) & (bucket_count - 1);
+        while (buckets[b] != -1) b = (b + 1) & (bucket_count - 1);
+        buckets[b] = id;
+    }
+
+    free(dictionary->buckets);
+    dictionary->buckets = buckets;
+    dictionary->bucket_count = bucket_count;
+    return 1;
+} // grow_buckets
+
+/**
+ * @brief Initializes an empty dictionary.
+ *
+ * @param dictionary Pointer to the dictionary to be initialized.
+ */
+void init_attribute_dictionary(AttributeDictionary *dictionary) {
+    *dictionary = (AttributeDictionary){0};
+} // init_attribute_dictionary
+
+/**
+ * @brief Looks up the id of an attribute without interning it.
+ *
+ * @param dictionary Pointer to the dictionary.
+ * @param name Attribute string.
+ * @return The id of the attribute, or -1 if it has not been interned.
+ */
+int find_attribute(const AttributeDictionary *dictionary, const char *name) {
+    if (dictionary->bucket_count == 0) return -1;
+
+    uint32_t mask = dictionary->bucket_count - 1;
+    for (uint32_t b = hash_attribute(name) & mask; dictionary->buckets[b] != -1; b = (b + 1) & mask) {
+        if (strcmp(attribute_name(dictionary, dictionary->buckets[b]), name) == 0) {
+            return dictionary->buckets[b];
+        }
+    }
+    return -1;
+} // find_attribute
+
+/**
+ * @brief Returns the id of an attribute, interning it on first use.
+ *
+ * @param dictionary Pointer to the dictionary.
+ * @param name Attribute string.
+ * @return The id of the attribute, or -1 on allocation failure.
+ */
+int intern_attribute(AttributeDictionary *dictionary, const char *name) {
+    int id = find_attribute(dictionary, name);
+    if (id != -1) return id;
+
+    if ((dictionary->count + 1) * 2 > dictionary->bucket_count && !grow_buckets(dictionary)) {
+        return -1;
+    }
+    if (dictionary->count == dictionary->capacity) {
+        int capacity = dictionary->capacity ? dictionary->capacity * 2 : INITIAL_BUCKETS / 2;
+        size_t *offsets = realloc(dictionary->offsets, capacity * sizeof(size_t));
+        if (!offsets) {
+            perror("Failed to allocate memory for attribute dictionary");
+            return -1;
+        }
+        dictionary->offsets = offsets;
+        dictionary->capacity = capacity;
+    }
+
+    size_t length = strlen(name) + 1;
+    if (dictionary->strings_size + length > dictionary->strings_capacity) {
+        size_t capacity = dictionary->strings_capacity ? dictionary->strings_capacity * 2 : INITIAL_STRINGS_SIZE;
+        while (capacity < dictionary->strings_size + length) capacity *= 2;
+        char *strings = realloc(dictionary->strings, capacity);
+        if (!strings) {
+            perror("Failed to allocate memory for attribute dictionary");
+            return -1;
+        }
+        dictionary->strings = strings;
+        dictionary->strings_capacity = capacity;
+    }
+
+    id = dictionary->count++;
+    dictionary->offsets[id] = dictionary->strings_size;
+    memcpy(dictionary->strings + dictionary->strings_size, name, length);
+    dictionary->strings_size += length;
+
+    uint32_t mask = dictionary->bucket_count - 1;
+    uint32_t b = hash_attribute(name) & mask;
+    while (dictionary->buckets[b] != -1) b = (b + 1) & mask;
+    dictionary->buckets[b] = id;
+    return id;
+} // intern_attribute
+
+/**
+ * @brief Returns the string of an interned id.
+ *
+ * The pointer is valid until the next call that interns, clears or frees.
+ *
+ * @param dictionary Pointer to the dictionary.
+ * @param id Id returned by `intern_attribute` or `find_attribute`.
+ * @return The attribute string.
+ */
+const char *attribute_name(const AttributeDictionary *dictionary, int id) {
+    return dictionary->strings + dictionary->offsets[id];
+} // attribute_name
+
+/**
+ * @brief Removes every interned string but keeps the allocated buffers.
+ *
+ * @param dictionary Pointer to the dictionary to be cleared.
+ */
+void clear_attribute_dictionary(AttributeDictionary *dictionary) {
+    dictionary->count = 0;
+    dictionary->strings_size = 0;
+    for (int b = 0; b < dictionary->bucket_count; b++) dictionary->buckets[b] = -1;
+} // clear_attribute_dictionary
+
+/**
+ * @brief Frees the string pool and the table itself.
+ *
+ * @param dictionary Pointer to the dictionary to be freed.
+ */
+void free_attribute_dictionary(AttributeDictionary *dictionary) {
+    free(dictionary->strings);
+    free(dictionary->offsets);
+    free(dictionary->buckets);
+    init_attribute_dictionary(dictionary);
+} // free_attribute_dictionary
@@ -0,0 +1,42 @@
+/**
+ * @file attribute_dictionary.h
+ * @brief Header file for the interned attribute dictionary.
+ *
+ * Declares a string-interning table that maps every distinct attribute to a
+ * small integer id, so compatibility scoring can compare integers instead of
+ * calling `strcmp` on every attribute pair.
+ *
+ * Notes:
+ * - Two attributes receive the same id if and only if their strings are equal.
+ * - Ids are stable until the dictionary is cleared or freed.
+ * - Clearing keeps every buffer, so refilling a dictionary with a similar set of
+ *   attributes does not allocate.
+ */
+#ifndef ATTRIBUTE_DICTIONARY_H
+#define ATTRIBUTE_DICTIONARY_H
+
+#include <stddef.h>
+
+/**
+ * @brief Hash table of interned attribute strings.
+ */
+typedef struct {
+    char *strings;            ///< Interned strings, NUL-terminated and packed back to back
+    size_t strings_size;      ///< Bytes used in `strings`
+    size_t strings_capacity;  ///< Allocated length of `strings`
+    size_t *offsets;          ///< Offset of each id's string in `strings`
+    int count;                ///< Number of interned strings
+    int capacity;             ///< Allocated length of `offsets`
+    int *buckets;             ///< Open-addressing table of ids (-1 when empty)
+    int bucket_count;         ///< Number of buckets (power of two)
+} AttributeDictionary;
+
+// Function Declarations
+void init_attribute_dictionary(AttributeDictionary *dictionary);
+int intern_attribute(AttributeDictionary *dictionary, const char *name);
+int find_attribute(const AttributeDictionary *dictionary, const char *name);
+const char *attribute_name(const AttributeDictionary *dictionary, int id);
+void clear_attribute_dictionary(AttributeDictionary *dictionary);
+void free_attribute_dictionary(AttributeDictionary *dictionary);
+
+#endif // ATTRIBUTE_DICTIONARY_H
@@ -0,0 +1,226 @@
+/**
+ * @file attribute_weights.c
+ * @brief Per-attribute scoring weights, from a file or from attribute rarity.
+ *
+ * Keeps one integer weight per interned attribute. Weights files are CSV with a
+ * header line followed by `Attribute,Weight` rows; IDF weights give rare
+ * attributes more weight than attributes most individuals share.
+ *
+ * Dependencies:
+ * - `attribute_weights.h`: Declares the interface for this functionality.
+ */
+#include "attribute_weights.h"
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Trims leading and trailing whitespace in place.
+ *
+ * @return Pointer to the first non-whitespace character.
+ */
+static char *trim(char *str) {
+    while (isspace((unsigned char)*str)) str++;
+    size_t len = strlen(str);
+    while (len > 0 && isspace((unsigned char)str[len - 1])) str[--len] = '\0';
+    return str;
+} // trim
+
+/**
+ * @brief Initializes an empty weight table, in which every attribute has the default weight.
+ *
+ * @param weights Pointer to the table to be initialized.
+ */
+void init_attribute_weights(AttributeWeights *weights) {
+    init_attribute_dictionary(&weights->dictionary);
+    weights->weights = NULL;
+    weights->capacity = 0;
+} // init_attribute_weights
+
+/**
+ * @brief Sets the weight of an attribute, replacing any earlier weight.
+ *
+ * @param weights Pointer to the table.
+ * @param name Attribute string.
+ * @param weight Weight between 0 and `MAX_ATTRIBUTE_WEIGHT`; 0 ignores the attribute.
+ * @return 1 on success, 0 on failure.
+ */
+int set_attribute_weight(AttributeWeights *weights, const char *name, int weight) {
+    if (weight < 0 || weight > MAX_ATTRIBUTE_WEIGHT) {
+        fprintf(stderr, "Error: Weight of '%s' must be between 0 and %d.\n", name, MAX_ATTRIBUTE_WEIGHT);
+        return 0;
+    }
+
+    int id = intern_attribute(&weights->dictionary, name);
+    if (id == -1) return 0;
+    if (id >= weights->capacity) {
+        int capacity = weights->capacity ? weights->capacity * 2 : 64;
+        while (capacity <= id) capacity *= 2;
+        int *grown = realloc(weights->weights, capacity * sizeof(int));
+        if (!grown) {
+            perror("Failed to allocate memory for attribute weights");
+            return 0;
+        }
+        weights->weights = grown;
+        weights->capacity = capacity;
+    }
+    weights->weights[id] = weight;
+    return 1;
+} // set_attribute_weight
+
+/**
+ * @brief Returns the weight of an attribute.
+ *
+ * @param weights Pointer to the table (may be NULL, in which case every weight is the default).
+ * @param name Attribute string.
+ * @return The weight set for the attribute, or `DEFAULT_ATTRIBUTE_WEIGHT`.
+ */
+int attribute_weight(const AttributeWeights *weights, const char *name) {
+    int id = weights ? find_attribute(&weights->dictionary, name) : -1;
+    return id == -1 ? DEFAULT_ATTRIBUTE_WEIGHT : weights->weights[id];
+} // attribute_weight
+
+/**
+ * @brief Reads attribute weights from a CSV file.
+ *
+ * The first line is a header and is skipped, like in the input files. Every other
+ * non-empty line holds an attribute and its integer weight, separated by a comma.
+ *
+ * @param weights Pointer to an initialized table to add the weights to.
+ * @param file_path Path to the weights file.
+ * @return 1 on success, 0 if the file cannot be read or a line is invalid.
+ */
+int load_attribute_weights(AttributeWeights *weights, const char *file_path) {
+    FILE *file = fopen(file_path, "r");
+    if (!file) {
+        perror("Error opening weights file");
+        return 0;
+    }
+
+    char line[MAX_LINE_LENGTH];
+    int line_number = 1;
+    int ok = 1;
+    if (!fgets(line, sizeof(line), file)) {
+        fprintf(stderr, "Error: Weights file %s is empty.\n", file_path);
+        ok = 0;
+    }
+
+    while (ok && fgets(line, sizeof(line), file)) {
+        line_number++;
+        char *name = trim(line);
+        if (*name == '\0') continue;
+
+        char *separator = strrchr(name, ',');
+        char *end = NULL;
+        long weight = 0;
+        if (separator) {
+            *separator = '\0';
+            errno = 0;
+            weight = strtol(separator + 1, &end, 10);
+            name = trim(name);
+        }
+        if (!separator || *name == '\0' || end == separator + 1 || *trim(end) != '\0' || errno != 0 ||
+            weight < 0 || weight > MAX_ATTRIBUTE_WEIGHT) {
+            fprintf(stderr, "Error: Invalid weight on line %d of %s (expected Attribute,Weight with a weight "
+                            "between 0 and %d).\n", line_number, file_path, MAX_ATTRIBUTE_WEIGHT);
+            ok = 0;
+            break;
+        }
+        ok = set_attribute_weight(weights, name, (int)weight);
+    }
+
+    fclose(file);
+    return ok;
+} // load_attribute_weights
+
+/**
+ * @brief Counts, for each attribute, the rows of a dataset that list it.
+ *
+ * Ids are interned into `dictionary`, and `seen` marks the row that last counted each
+ * id so attributes listed twice in a row count once.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+static int count_rows_with_attribute(AttributeDictionary *dictionary, const DataSet *dataset, int **rows_with,
+                                     int **seen, int *capacity, int *row_id) {
+    for (int i = 0; i < dataset->row_count; i++, (*row_id)++) {
+        for (int a = 0; a < dataset->rows[i].attributes_count; a++) {
+            int id = intern_attribute(dictionary, dataset->rows[i].attributes[a]);
+            if (id == -1) return 0;
+            if (id >= *capacity) {
+                int new_capacity = *capacity ? *capacity * 2 : 64;
+                while (new_capacity <= id) new_capacity *= 2;
+                int *grown_rows = realloc(*rows_with, new_capacity * sizeof(int));
+                if (grown_rows) *rows_with = grown_rows;
+                int *grown_seen = grown_rows ? realloc(*seen, new_capacity * sizeof(int)) : NULL;
+                if (!grown_seen) {
+                    perror("Failed to allocate memory for attribute weights");
+                    return 0;
+                }
+                *seen = grown_seen;
+                for (int k = *capacity; k < new_capacity; k++) {
+                    (*rows_with)[k] = 0;
+                    (*seen)[k] = -1;
+                }
+                *capacity = new_capacity;
+            }
+            if ((*seen)[id] != *row_id) {
+                (*seen)[id] = *row_id;
+                (*rows_with)[id]++;
+            }
+        }
+    }
+    return 1;
+} // count_rows_with_attribute
+
+/**
+ * @brief Weights every attribute of both datasets by its inverse document frequency.
+ *
+ * An attribute listed by `k` of the `N` rows of both datasets weighs
+ * `round(IDF_WEIGHT_SCALE * ln(N / k))`, and at least 1 so that every shared attribute
+ * still counts. Weights already in the table for other attributes are kept.
+ *
+ * @param weights Pointer to an initialized table to add the weights to.
+ * @param dataset1 Pointer to the first dataset (e.g., mentees or participants).
+ * @param dataset2 Pointer to the second dataset (e.g., mentors or panels).
+ * @return 1 on success, 0 on failure.
+ */
+int compute_idf_weights(AttributeWeights *weights, const DataSet *dataset1, const DataSet *dataset2) {
+    AttributeDictionary dictionary;
+    init_attribute_dictionary(&dictionary);
+    int *rows_with = NULL;
+    int *seen = NULL;
+    int capacity = 0;
+    int row_id = 0;
+
+    int ok = count_rows_with_attribute(&dictionary, dataset1, &rows_with, &seen, &capacity, &row_id) &&
+             count_rows_with_attribute(&dictionary, dataset2, &rows_with, &seen, &capacity, &row_id);
+
+    for (int id = 0; ok && id < dictionary.count; id++) {
+        long weight = lround(IDF_WEIGHT_SCALE * log((double)row_id / rows_with[id]));
+        if (weight < 1) weight = 1;
+        if (weight > MAX_ATTRIBUTE_WEIGHT) weight = MAX_ATTRIBUTE_WEIGHT;
+        ok = set_attribute_weight(weights, attribute_name(&dictionary, id), (int)weight);
+    }
+
+    free(rows_with);
+    free(seen);
+    free_attribute_dictionary(&dictionary);
+    return ok;
+} // compute_idf_weights
+
+/**
+ * @brief Frees the memory held by a weight table.
+ *
+ * @param weights Pointer to the table to be freed.
+ */
+void free_attribute_weights(AttributeWeights *weights) {
+    if (!weights) return;
+    free_attribute_dictionary(&weights->dictionary);
+    free(weights->weights);
+    weights->weights = NULL;
+    weights->capacity = 0;
+} // free_attribute_weights
@@ -0,0 +1,55 @@
+/**
+ * @file attribute_weights.h
+ * @brief Header file for per-attribute scoring weights.
+ *
+ * Declares a table of integer weights keyed by attribute. A shared attribute
+ * contributes its weight, instead of 1, to the compatibility score of a pair, so
+ * a weight of 3 scores like listing the attribute three times on one side.
+ * Weights are read from a file or derived from how rare each attribute is
+ * across both datasets (inverse document frequency).
+ *
+ * Dependencies:
+ * - `attribute_dictionary.h`: Interns the weighted attribute strings.
+ * - `input_parser.h`: Defines the `DataSet` structure used for IDF weights.
+ *
+ * Notes:
+ * - Attributes without an explicit weight weigh `DEFAULT_ATTRIBUTE_WEIGHT`.
+ * - Weights are non-negative integers, so weighted scores remain integers.
+ */
+#ifndef ATTRIBUTE_WEIGHTS_H
+#define ATTRIBUTE_WEIGHTS_H
+
+#include "attribute_dictionary.h"
+#include "input_parser.h"
+
+#define DEFAULT_ATTRIBUTE_WEIGHT 1 // Weight of attributes missing from the table
+#define MAX_ATTRIBUTE_WEIGHT 1000  // Largest accepted weight, which keeps scores well within an int
+#define IDF_WEIGHT_SCALE 10        // IDF weights are round(IDF_WEIGHT_SCALE * ln(rows / rows_with_attribute))
+
+/**
+ * @brief Source of the weights of a run.
+ */
+typedef enum {
+    WEIGHTS_NONE = 0,  ///< Every shared attribute counts 1
+    WEIGHTS_FILE = 1,  ///< Weights read with `load_attribute_weights`
+    WEIGHTS_IDF = 2    ///< Weights derived with `compute_idf_weights`
+} WeightMode;
+
+/**
+ * @brief Weights of individual attributes.
+ */
+typedef struct {
+    AttributeDictionary dictionary; ///< Attributes with an explicit weight
+    int *weights;                   ///< Weight of each attribute, indexed by dictionary id
+    int capacity;                   ///< Allocated length of `weights`
+} AttributeWeights;
+
+// Function Declarations
+void init_attribute_weights(AttributeWeights *weights);
+int set_attribute_weight(AttributeWeights *weights, const char *name, int weight);
+int attribute_weight(const AttributeWeights *weights, const char *name);
+int load_attribute_weights(AttributeWeights *weights, const char *file_path);
+int compute_idf_weights(AttributeWeights *weights, const DataSet *dataset1, const DataSet *dataset2);
+void free_attribute_weights(AttributeWeights *weights);
+
+#endif // ATTRIBUTE_WEIGHTS_H
@@ -0,0 +1,543 @@
+/**
+ * @file checkpoint.c
+ * @brief Compact binary checkpoints for resuming long-running solves.
+ *
+ * A checkpoint file contains a small header, the matching category, the identity
+ * of the run (fingerprints of its input files and its solver and weight settings),
+ * both parsed datasets and the score matrix. It is written once per run. The
+ * partial solver state goes to a separate record of O(n + m) bytes that names the
+ * checkpoint it continues, so saving solver progress never rewrites the matrix.
+ *
+ * Every file ends with an FNV-1a checksum. Loading verifies it before anything is
+ * parsed, and every count read from the file is capped by the bytes left in it, so
+ * truncated or corrupted files are rejected without allocating from their contents.
+ *
+ * Dependencies:
+ * - `checkpoint.h`: Declares the interface for this functionality.
+ */
+#include "checkpoint.h"
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CHECKPOINT_MAGIC "PAIRCKPT"        // File signature
+#define SOLVER_CHECKPOINT_MAGIC "PAIRSOLV" // Signature of the solver state record
+#define CHECKPOINT_VERSION 2               // Bumped whenever the layout changes
+#define MIN_ROW_BYTES 12                   // Name length, capacity and attribute count of a row
+#define FINGERPRINT_BUFFER_SIZE 65536      // Bytes read at a time when fingerprinting a file
+
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+/**
+ * @brief Stream wrapper that keeps a running checksum of every byte transferred.
+ */
+typedef struct {
+    FILE *file;
+    uint64_t checksum;
+    uint64_t remaining;  // Bytes left before the checksum when reading
+    int ok;              // Cleared on the first I/O error
+} CheckpointStream;
+
+/**
+ * @brief Folds a block of bytes into the running FNV-1a checksum.
+ */
+static void update_checksum(CheckpointStream *stream, const void *data, size_t size) {
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        stream->checksum = (stream->checksum ^ bytes[i]) * FNV_PRIME;
+    }
+} // update_checksum
+
+static void write_bytes(CheckpointStream *stream, const void *data, size_t size) {
+    if (!stream->ok || size == 0) return;
+    if (fwrite(data, 1, size, stream->file) != size) {
+        stream->ok = 0;
+        return;
+    }
+    update_checksum(stream, data, size);
+} // write_bytes
+
+static void read_bytes(CheckpointStream *stream, void *data, size_t size) {
+    if (!stream->ok || size == 0) return;
+    if (size > stream->remaining || fread(data, 1, size, stream->file) != size) {
+        stream->ok = 0;
+        return;
+    }
+    stream->remaining -= size;
+    update_checksum(stream, data, size);
+} // read_bytes
+
+static void write_int(CheckpointStream *stream, int value) {
+    int32_t v = value;
+    write_bytes(stream, &v, sizeof(v));
+} // write_int
+
+static int read_int(CheckpointStream *stream) {
+    int32_t v = 0;
+    read_bytes(stream, &v, sizeof(v));
+    return v;
+} // read_int
+
+static void write_u64(CheckpointStream *stream, uint64_t value) {
+    write_bytes(stream, &value, sizeof(value));
+} // write_u64
+
+static uint64_t read_u64(CheckpointStream *stream) {
+    uint64_t v = 0;
+    read_bytes(stream, &v, sizeof(v));
+    return v;
+} // read_u64
+
+/**
+ * @brief Reads a count of items that take at least `min_bytes` each in the file.
+ *
+ * @return The count, or -1 (with the stream failed) if it is negative or the rest
+ *         of the file cannot hold that many items.
+ */
+static int read_count(CheckpointStream *stream, size_t min_bytes) {
+    int count = read_int(stream);
+    if (!stream->ok || count < 0 || (uint64_t)count * min_bytes > stream->remaining) {
+        stream->ok = 0;
+        return -1;
+    }
+    return count;
+} // read_count
+
+static void write_string(CheckpointStream *stream, const char *str) {
+    int len = str ? (int)strlen(str) : 0;
+    write_int(stream, len);
+    write_bytes(stream, str, len);
+} // write_string
+
+/**
+ * @brief Reads a length-prefixed string into a newly allocated buffer.
+ *
+ * @return The string, or NULL on failure.
+ */
+static char *read_string(CheckpointStream *stream) {
+    int len = read_count(stream, 1);
+    if (len < 0) return NULL;
+    char *str = malloc(len + 1);
+    if (!str) {
+        stream->ok = 0;
+        return NULL;
+    }
+    read_bytes(stream, str, len);
+    str[len] = '\0';
+    return str;
+} // read_string
+
+static void write_dataset(CheckpointStream *stream, const DataSet *dataset) {
+    write_int(stream, dataset->row_count);
+    for (int i = 0; i < dataset->row_count; i++) {
+        DataRow *row = &dataset->rows[i];
+        write_string(stream, row->name);
+        write_int(stream, row->capacity);
+        write_int(stream, row->attributes_count);
+        for (int j = 0; j < row->attributes_count; j++) {
+            write_string(stream, row->attributes[j]);
+        }
+    }
+} // write_dataset
+
+/**
+ * @brief Reads a dataset in the layout produced by `write_dataset`.
+ *
+ * The returned dataset can be released with `free_dataset`.
+ *
+ * @return Pointer to the dataset, or NULL on failure.
+ */
+static DataSet *read_dataset(CheckpointStream *stream) {
+    int row_count = read_count(stream, MIN_ROW_BYTES);
+    if (row_count < 0) return NULL;
+
+    DataSet *dataset = malloc(sizeof(DataSet));
+    if (!dataset) {
+        stream->ok = 0;
+        return NULL;
+    }
+    dataset->row_count = 0;
+    dataset->rows = calloc(row_count > 0 ? row_count : 1, sizeof(DataRow));
+    if (!dataset->rows) {
+        free(dataset);
+        stream->ok = 0;
+        return NULL;
+    }
+
+    for (int i = 0; i < row_count && stream->ok; i++) {
+        DataRow *row = &dataset->rows[i];
+        dataset->row_count++;
+        row->name = read_string(stream);
+        row->capacity = read_int(stream);
+        int attributes_count = read_count(stream, sizeof(int32_t));
+        if (attributes_count < 0) break;
+        row->attributes = malloc((attributes_count > 0 ? attributes_count : 1) * sizeof(char *));
+        if (!row->attributes) {
+            stream->ok = 0;
+            break;
+        }
+        for (int j = 0; j < attributes_count && stream->ok; j++) {
+            char *attribute = read_string(stream);
+            if (attribute) row->attributes[row->attributes_count++] = attribute;
+        }
+    }
+
+    if (!stream->ok) {
+        free_dataset(dataset);
+        return NULL;
+    }
+    return dataset;
+} // read_dataset
+
+/**
+ * @brief Computes a fingerprint of a file's contents.
+ *
+ * Used to tell whether a resumed run reads the same inputs as the checkpointed one,
+ * regardless of where the files are or when they were last touched.
+ *
+ * @param path Path of the file.
+ * @param fingerprint Set to the FNV-1a hash of the size and contents of the file.
+ * @return 1 on success, 0 if the file cannot be read.
+ */
+int fingerprint_file(const char *path, uint64_t *fingerprint) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        perror("Failed to fingerprint input file");
+        return 0;
+    }
+
+    CheckpointStream stream = {.file = file, .checksum = FNV_OFFSET_BASIS, .ok = 1};
+    unsigned char buffer[FINGERPRINT_BUFFER_SIZE];
+    uint64_t size = 0;
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        update_checksum(&stream, buffer, read);
+        size += read;
+    }
+    int ok = !ferror(file);
+    fclose(file);
+    update_checksum(&stream, &size, sizeof(size));
+    *fingerprint = stream.checksum;
+    return ok;
+} // fingerprint_file
+
+/**
+ * @brief Opens the temporary file of an atomic write.
+ *
+ * @return The stream, with `ok` cleared if the file could not be created.
+ */
+static CheckpointStream begin_atomic_write(const char *tmp_path) {
+    CheckpointStream stream = {.file = fopen(tmp_path, "wb"), .checksum = FNV_OFFSET_BASIS, .ok = 1};
+    if (!stream.file) {
+        perror("Failed to open checkpoint file");
+        stream.ok = 0;
+    }
+    return stream;
+} // begin_atomic_write
+
+/**
+ * @brief Appends the checksum, flushes the temporary file to disk and renames it over `path`.
+ *
+ * An interruption at any point leaves the previous file at `path` intact.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+static int finish_atomic_write(CheckpointStream *stream, const char *tmp_path, const char *path) {
+    if (!stream->file) return 0;
+
+    uint64_t checksum = stream->checksum;
+    if (stream->ok && fwrite(&checksum, sizeof(checksum), 1, stream->file) != 1) stream->ok = 0;
+    if (stream->ok && (fflush(stream->file) != 0 || fsync(fileno(stream->file)) != 0)) stream->ok = 0;
+    if (fclose(stream->file) != 0) stream->ok = 0;
+
+    if (!stream->ok || rename(tmp_path, path) != 0) {
+        perror("Failed to write checkpoint");
+        remove(tmp_path);
+        return 0;
+    }
+    return 1;
+} // finish_atomic_write
+
+/**
+ * @brief Opens a checkpoint file and verifies its checksum before anything is parsed.
+ *
+ * @param path Path of the file.
+ * @param stream Set up to read the payload, with `remaining` bytes before the checksum.
+ * @param exists Set to false if there is no file at `path`.
+ * @return 1 if the file is intact, 0 otherwise.
+ */
+static int open_verified(const char *path, CheckpointStream *stream, bool *exists) {
+    *stream = (CheckpointStream){.file = fopen(path, "rb"), .checksum = FNV_OFFSET_BASIS, .ok = 1};
+    *exists = stream->file != NULL;
+    if (!stream->file) return 0;
+
+    struct stat st;
+    if (fstat(fileno(stream->file), &st) != 0 || st.st_size < (off_t)sizeof(uint64_t)) {
+        fclose(stream->file);
+        stream->file = NULL;
+        return 0;
+    }
+
+    // First pass: checksum the payload and compare it with the stored one
+    stream->remaining = (uint64_t)st.st_size - sizeof(uint64_t);
+    unsigned char buffer[FINGERPRINT_BUFFER_SIZE];
+    for (uint64_t left = stream->remaining; left > 0 && stream->ok;) {
+        size_t chunk = left < sizeof(buffer) ? (size_t)left : sizeof(buffer);
+        if (fread(buffer, 1, chunk, stream->file) != chunk) stream->ok = 0;
+        update_checksum(stream, buffer, chunk);
+        left -= chunk;
+    }
+    uint64_t stored = 0;
+    if (!stream->ok || fread(&stored, sizeof(stored), 1, stream->file) != 1 || stored != stream->checksum) {
+        fclose(stream->file);
+        stream->file = NULL;
+        return 0;
+    }
+
+    // Second pass parses the verified payload
+    rewind(stream->file);
+    stream->checksum = FNV_OFFSET_BASIS;
+    return 1;
+} // open_verified
+
+static void write_identity(CheckpointStream *stream, const CheckpointIdentity *identity) {
+    write_u64(stream, identity->file1_fingerprint);
+    write_u64(stream, identity->file2_fingerprint);
+    write_int(stream, identity->solver);
+    write_int(stream, identity->weight_mode);
+    write_u64(stream, identity->weights_fingerprint);
+} // write_identity
+
+static void read_identity(CheckpointStream *stream, CheckpointIdentity *identity) {
+    identity->file1_fingerprint = read_u64(stream);
+    identity->file2_fingerprint = read_u64(stream);
+    identity->solver = read_int(stream);
+    identity->weight_mode = read_int(stream);
+    identity->weights_fingerprint = read_u64(stream);
+} // read_identity
+
+/**
+ * @brief Builds the path of a file that sits next to a checkpoint, `<path><suffix>`.
+ *
+ * @param buffer Buffer of `PATH_MAX` bytes.
+ * @return 1 on success, 0 if the path does not fit.
+ */
+static int checkpoint_file_path(char *buffer, const char *path, const char *suffix) {
+    if (snprintf(buffer, PATH_MAX, "%s%s", path, suffix) >= PATH_MAX) {
+        fprintf(stderr, "Error: Checkpoint path is too long: %s\n", path);
+        return 0;
+    }
+    return 1;
+} // checkpoint_file_path
+
+/**
+ * @brief Writes a checkpoint of the scored run atomically.
+ *
+ * The checkpoint is written to `<path>.tmp`, flushed to disk and renamed over `path`,
+ * so an interruption while saving leaves the previous checkpoint intact. Solver state
+ * saved for an earlier checkpoint at `path` is discarded.
+ *
+ * @param path Path of the checkpoint file.
+ * @param checkpoint Pointer to the state to be saved; its `run_id` is set to identify
+ *                   the written file to later `save_solver_checkpoint` calls.
+ * @return 1 on success, 0 on failure.
+ */
+int save_checkpoint(const char *path, Checkpoint *checkpoint) {
+    char tmp_path[PATH_MAX];
+    char solver_path[PATH_MAX];
+    if (!checkpoint_file_path(tmp_path, path, ".tmp") ||
+        !checkpoint_file_path(solver_path, path, SOLVER_CHECKPOINT_SUFFIX)) {
+        return 0;
+    }
+
+    CheckpointStream stream = begin_atomic_write(tmp_path);
+    write_bytes(&stream, CHECKPOINT_MAGIC, strlen(CHECKPOINT_MAGIC));
+    write_int(&stream, CHECKPOINT_VERSION);
+    write_string(&stream, checkpoint->category);
+    write_identity(&stream, &checkpoint->identity);
+    write_dataset(&stream, checkpoint->dataset1);
+    write_dataset(&stream, checkpoint->dataset2);
+    size_t matrix_size = (size_t)checkpoint->dataset1->row_count * checkpoint->dataset2->row_count * sizeof(int);
+    write_bytes(&stream, checkpoint->compatibility_scores, matrix_size);
+    checkpoint->run_id = stream.checksum;
+
+    // Drop stale solver state first, so it can never be paired with the new checkpoint
+    if (stream.ok) remove(solver_path);
+    return finish_atomic_write(&stream, tmp_path, path);
+} // save_checkpoint
+
+/**
+ * @brief Writes the partial solver state of a checkpointed run atomically.
+ *
+ * Only the solver state is written, O(n + m) bytes, tagged with the `run_id` of the
+ * checkpoint it continues.
+ *
+ * @param path Path of the checkpoint file saved by `save_checkpoint`.
+ * @param checkpoint Pointer to the run's checkpoint, whose `solver` state is saved.
+ * @return 1 on success, 0 on failure.
+ */
+int save_solver_checkpoint(const char *path, const Checkpoint *checkpoint) {
+    char solver_path[PATH_MAX];
+    char tmp_path[PATH_MAX];
+    if (!checkpoint_file_path(solver_path, path, SOLVER_CHECKPOINT_SUFFIX) ||
+        !checkpoint_file_path(tmp_path, path, SOLVER_CHECKPOINT_SUFFIX ".tmp")) {
+        return 0;
+    }
+
+    int n = checkpoint->dataset1->row_count;
+    int m = checkpoint->dataset2->row_count;
+    CheckpointStream stream = begin_atomic_write(tmp_path);
+    write_bytes(&stream, SOLVER_CHECKPOINT_MAGIC, strlen(SOLVER_CHECKPOINT_MAGIC));
+    write_int(&stream, CHECKPOINT_VERSION);
+    write_u64(&stream, checkpoint->run_id);
+    write_int(&stream, n);
+    write_int(&stream, m);
+    write_int(&stream, checkpoint->solver.next_row);
+    write_bytes(&stream, checkpoint->solver.row_assigned, n * sizeof(int));
+    write_bytes(&stream, checkpoint->solver.capacity_remaining, m * sizeof(int));
+    return finish_atomic_write(&stream, tmp_path, solver_path);
+} // save_solver_checkpoint
+
+/**
+ * @brief Loads the solver state record that continues a loaded checkpoint, if any.
+ *
+ * @return 1 if there is no record or it was loaded, 0 if it is invalid or belongs to another checkpoint.
+ */
+static int load_solver_checkpoint(const char *path, Checkpoint *checkpoint) {
+    char solver_path[PATH_MAX];
+    if (!checkpoint_file_path(solver_path, path, SOLVER_CHECKPOINT_SUFFIX)) return 0;
+
+    CheckpointStream stream;
+    bool exists;
+    if (!open_verified(solver_path, &stream, &exists)) return !exists;
+
+    int n = checkpoint->dataset1->row_count;
+    int m = checkpoint->dataset2->row_count;
+    char magic[sizeof(SOLVER_CHECKPOINT_MAGIC)] = {0};
+    read_bytes(&stream, magic, strlen(SOLVER_CHECKPOINT_MAGIC));
+    int version = read_int(&stream);
+    uint64_t run_id = read_u64(&stream);
+    int rows = read_int(&stream);
+    int columns = read_int(&stream);
+    int next_row = read_int(&stream);
+    if (!stream.ok || strcmp(magic, SOLVER_CHECKPOINT_MAGIC) != 0 || version != CHECKPOINT_VERSION ||
+        run_id != checkpoint->run_id || rows != n || columns != m || next_row < 0 || next_row > n) {
+        fclose(stream.file);
+        return 0;
+    }
+
+    checkpoint->solver.next_row = next_row;
+    checkpoint->solver.row_assigned = malloc((n > 0 ? n : 1) * sizeof(int));
+    checkpoint->solver.capacity_remaining = malloc((m > 0 ? m : 1) * sizeof(int));
+    if (!checkpoint->solver.row_assigned || !checkpoint->solver.capacity_remaining) stream.ok = 0;
+    read_bytes(&stream, checkpoint->solver.row_assigned, n * sizeof(int));
+    read_bytes(&stream, checkpoint->solver.capacity_remaining, m * sizeof(int));
+    for (int i = 0; stream.ok && i < next_row; i++) {
+        if (checkpoint->solver.row_assigned[i] < -1 || checkpoint->solver.row_assigned[i] >= m) stream.ok = 0;
+    }
+    fclose(stream.file);
+
+    if (stream.ok) checkpoint->stage = CHECKPOINT_SOLVING;
+    return stream.ok;
+} // load_solver_checkpoint
+
+/**
+ * @brief Loads a checkpoint written by `save_checkpoint`, with its latest solver state.
+ *
+ * @param path Path of the checkpoint file.
+ * @param success Pointer to a boolean set to false if the file exists but is invalid.
+ * @return Pointer to the loaded checkpoint, or NULL if there is none or it is invalid.
+ *         The checkpoint must be released with `free_checkpoint`.
+ */
+Checkpoint *load_checkpoint(const char *path, bool *success) {
+    *success = true;
+    CheckpointStream stream;
+    bool exists;
+    int intact = open_verified(path, &stream, &exists);
+    if (!exists) return NULL; // Nothing to resume from
+
+    *success = false;
+    if (!intact) {
+        fprintf(stderr, "Error: Checkpoint file %s is truncated or corrupted.\n", path);
+        return NULL;
+    }
+
+    char magic[sizeof(CHECKPOINT_MAGIC)] = {0};
+    read_bytes(&stream, magic, strlen(CHECKPOINT_MAGIC));
+    int version = read_int(&stream);
+    if (!stream.ok || strcmp(magic, CHECKPOINT_MAGIC) != 0 || version != CHECKPOINT_VERSION) {
+        fprintf(stderr, "Error: %s is not a compatible checkpoint file.\n", path);
+        fclose(stream.file);
+        return NULL;
+    }
+
+    Checkpoint *checkpoint = calloc(1, sizeof(Checkpoint));
+    if (!checkpoint) {
+        perror("Error allocating memory for checkpoint");
+        fclose(stream.file);
+        return NULL;
+    }
+    checkpoint->stage = CHECKPOINT_SCORED;
+    checkpoint->category = read_string(&stream);
+    read_identity(&stream, &checkpoint->identity);
+    checkpoint->dataset1 = read_dataset(&stream);
+    checkpoint->dataset2 = read_dataset(&stream);
+
+    if (stream.ok) {
+        uint64_t size = (uint64_t)checkpoint->dataset1->row_count * checkpoint->dataset2->row_count * sizeof(int);
+        if (size != stream.remaining) stream.ok = 0; // The matrix is the rest of the payload
+        checkpoint->compatibility_scores = stream.ok ? malloc(size > 0 ? size : 1) : NULL;
+        if (!checkpoint->compatibility_scores) stream.ok = 0;
+        read_bytes(&stream, checkpoint->compatibility_scores, size);
+    }
+    checkpoint->run_id = stream.checksum;
+    fclose(stream.file);
+
+    if (!stream.ok) {
+        fprintf(stderr, "Error: Checkpoint file %s is truncated or corrupted.\n", path);
+        free_checkpoint(checkpoint);
+        return NULL;
+    }
+    if (!load_solver_checkpoint(path, checkpoint)) {
+        fprintf(stderr, "Error: Solver state %s%s is corrupted or belongs to another checkpoint.\n", path,
+                SOLVER_CHECKPOINT_SUFFIX);
+        free_checkpoint(checkpoint);
+        return NULL;
+    }
+
+    *success = true;
+    return checkpoint;
+} // load_checkpoint
+
+/**
+ * @brief Removes a checkpoint and its solver state.
+ *
+ * @param path Path of the checkpoint file.
+ */
+void remove_checkpoint(const char *path) {
+    char solver_path[PATH_MAX];
+    if (checkpoint_file_path(solver_path, path, SOLVER_CHECKPOINT_SUFFIX)) remove(solver_path);
+    remove(path);
+} // remove_checkpoint
+
+/**
+ * @brief Frees a checkpoint and every buffer it still owns.
+ *
+ * @param checkpoint Pointer to the checkpoint to be freed.
+ */
+void free_checkpoint(Checkpoint *checkpoint) {
+    if (!checkpoint) return;
+
+    free(checkpoint->category);
+    free_dataset(checkpoint->dataset1);
+    free_dataset(checkpoint->dataset2);
+    free(checkpoint->compatibility_scores);
+    free(checkpoint->solver.row_assigned);
+    free(checkpoint->solver.capacity_remaining);
+    free(checkpoint);
+} // free_checkpoint
@@ -0,0 +1,79 @@
+/**
+ * @file checkpoint.h
+ * @brief Header file for saving and restoring pipeline checkpoints.
+ *
+ * Declares the structures and functions used to persist the state of a run in
+ * compact binary files so that an interrupted run can be resumed. The checkpoint
+ * file holds what the run was started with, the parsed datasets and the score
+ * matrix, and is written once, after scoring. The partial solver state is small
+ * and is saved separately, next to it, as often as the solver reports progress.
+ *
+ * Dependencies:
+ * - `input_parser.h`: Defines the `DataSet` and `DataRow` structures.
+ * - `solution_selector.h`: Defines the `SolverState` structure.
+ *
+ * Notes:
+ * - Both files are written to a temporary file and renamed into place, so they
+ *   always hold the last consistent checkpoint.
+ * - Checkpoints use the native byte order and are not meant to be moved between machines.
+ */
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "input_parser.h"
+#include "solution_selector.h"
+
+#define DEFAULT_CHECKPOINT_PATH "pairing.ckpt"  // Checkpoint file used by `--resume` alone
+#define DEFAULT_CHECKPOINT_INTERVAL 1000       // Mentees assigned between solver checkpoints
+#define SOLVER_CHECKPOINT_SUFFIX ".solver"     // Appended to the checkpoint path for the solver state
+
+/**
+ * @brief Furthest pipeline stage captured by a checkpoint.
+ */
+typedef enum {
+    CHECKPOINT_NONE = 0,     ///< Nothing has been checkpointed; the run starts from the beginning
+    CHECKPOINT_SCORED = 2,   ///< The compatibility score matrix has been computed
+    CHECKPOINT_SOLVING = 3   ///< The solver has assigned part of the mentees
+} CheckpointStage;
+
+/**
+ * @brief Inputs and settings that determine the score matrix and the assignment.
+ *
+ * A checkpoint may only be resumed by a run whose identity is equal.
+ */
+typedef struct {
+    uint64_t file1_fingerprint;    ///< Fingerprint of the first input file
+    uint64_t file2_fingerprint;    ///< Fingerprint of the second input file
+    int32_t solver;                ///< `SolverKind` of the run
+    int32_t weight_mode;           ///< `WeightMode` of the run
+    uint64_t weights_fingerprint;  ///< Fingerprint of the weights file, or 0 without one
+} CheckpointIdentity;
+
+/**
+ * @brief In-memory representation of a checkpoint.
+ *
+ * The solver state is set only at `CHECKPOINT_SOLVING`. Pointers taken out of a
+ * loaded checkpoint should be set to NULL before calling `free_checkpoint`.
+ */
+typedef struct {
+    CheckpointStage stage;        ///< Furthest completed stage
+    char *category;               ///< Matching category the run was started with
+    CheckpointIdentity identity;  ///< Inputs and settings the run was started with
+    uint64_t run_id;              ///< Ties the solver state to the checkpoint file it continues
+    DataSet *dataset1;            ///< First dataset (mentees or participants)
+    DataSet *dataset2;            ///< Second dataset (mentors or panels)
+    int *compatibility_scores;    ///< Score matrix
+    SolverState solver;           ///< Partial solver state (stage == CHECKPOINT_SOLVING)
+} Checkpoint;
+
+// Function Declarations
+int fingerprint_file(const char *path, uint64_t *fingerprint);
+int save_checkpoint(const char *path, Checkpoint *checkpoint);
+int save_solver_checkpoint(const char *path, const Checkpoint *checkpoint);
+Checkpoint *load_checkpoint(const char *path, bool *success);
+void remove_checkpoint(const char *path);
+void free_checkpoint(Checkpoint *checkpoint);
+
+#endif // CHECKPOINT_H
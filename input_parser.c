@@ -15,7 +15,6 @@
 #include <string.h>
 #include <ctype.h>
 
-#define MAX_LINE_LENGTH 1024 // Maximum length of a line in the input CSV file
 #define MAX_ATTRIBUTES 10 // Maximum number of attributes allowed per row
 
 /**
@@ -60,6 +59,48 @@ static void split_attributes(char *attribute_str, DataRow *row) {
     }
 } // split_attributes
 
+/**
+ * Parses one CSV line into a DataRow object.
+ *
+ * The line is tokenized in place. It must sit in a buffer of `MAX_LINE_LENGTH` bytes,
+ * as filled by `fgets`, because the capacity scan may look a few bytes past its end.
+ *
+ * @param line Line of the CSV file, without the header.
+ * @param row Pointer to the DataRow to be filled in; release it with `free_data_row`.
+ * @return true on success, false if memory could not be allocated.
+ */
+bool parse_csv_row(char *line, DataRow *row) {
+    *row = (DataRow){0};
+    row->attributes = (char **)malloc(MAX_ATTRIBUTES * sizeof(char *));
+    if (!row->attributes) {
+        perror("Error allocating memory for attributes");
+        return false;
+    }
+
+    // Tokenize the line by commas
+    char *token = strtok(line, ",");
+    if (token) {
+        trim_whitespace(token);
+        row->name = strdup(token);
+    }
+
+    // Process the remaining tokens for attributes and capacity
+    while ((token = strtok(NULL, ",")) != NULL) {
+        trim_whitespace(token);
+        
+        for (size_t i = 0; i < strlen(token)+3; i++) {
+            if (isdigit(token[i])) {
+                row->capacity = atoi(&token[i]);
+            }
+        }
+        
+       if (row->attributes_count < MAX_ATTRIBUTES) {
+            split_attributes(token, row);
+        }
+    }
+    return true;
+} // parse_csv_row
+
 /**
  * Parses a CSV file and populates a DataSet object with its contents.
  *
@@ -101,38 +142,12 @@ DataSet *parse_csv(const char *file_path, bool *success) {
     // Read and process each subsequent line
     while (fgets(line, MAX_LINE_LENGTH, file)) {
         DataRow row;
-        row.attributes = (char **)malloc(MAX_ATTRIBUTES * sizeof(char *));
-        row.attributes_count = 0;
-
-        if (!row.attributes) {
-            perror("Error allocating memory for attributes");
+        if (!parse_csv_row(line, &row)) {
             free_dataset(dataset);
             *success = false;
             fclose(file);
             return NULL;
         }
-        
-        // Tokenize the line by commas
-        char *token = strtok(line, ",");
-        if (token) {
-            trim_whitespace(token);
-            row.name = strdup(token);
-        }
-
-        // Process the remaining tokens for attributes and capacity
-        while ((token = strtok(NULL, ",")) != NULL) {
-            trim_whitespace(token);
-            
-            for (size_t i = 0; i < strlen(token)+3; i++) {
-                if (isdigit(token[i])) {
-                    row.capacity = atoi(&token[i]);
-                }
-            }
-            
-           if (row.attributes_count < MAX_ATTRIBUTES) {
-                split_attributes(token, &row);
-            }
-        }
 
         // Resize the rows array in the dataset
         dataset->rows = (DataRow *)realloc(dataset->rows, (dataset->row_count + 1) * sizeof(DataRow));
@@ -153,6 +168,19 @@ DataSet *parse_csv(const char *file_path, bool *success) {
     return dataset;
 } // parse_csv
 
+/**
+ * Frees the name and attributes of a single DataRow object.
+ *
+ * @param row Pointer to the DataRow whose contents are freed.
+ */
+void free_data_row(DataRow *row) {
+    free(row->name);
+    for (int j = 0; j < row->attributes_count; j++) {
+        free(row->attributes[j]);
+    }
+    free(row->attributes);
+} // free_data_row
+
 /**
  * Frees the memory allocated for a DataSet object, including its rows and attributes.
  *
@@ -163,11 +191,7 @@ void free_dataset(DataSet *dataset) {
 
     // Free each row and its attributes
     for (int i = 0; i < dataset->row_count; i++) {
-        free(dataset->rows[i].name);
-        for (int j = 0; j < dataset->rows[i].attributes_count; j++) {
-            free(dataset->rows[i].attributes[j]);
-        }
-        free(dataset->rows[i].attributes);
+        free_data_row(&dataset->rows[i]);
     }
 
     // Free the rows array and the dataset itself
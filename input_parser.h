@@ -9,6 +9,8 @@
 #define INPUT_PARSER_H
 #include <stdbool.h>
 
+#define MAX_LINE_LENGTH 1024 // Maximum length of a line in the input CSV file
+
 /**
  * @brief Represents an individual data row (e.g., Mentor or Mentee).
  *
@@ -34,6 +36,8 @@ typedef struct {
 
 // Function Declarations
 DataSet *parse_csv(const char *file_path, bool *success);
+bool parse_csv_row(char *line, DataRow *row);
+void free_data_row(DataRow *row);
 void free_dataset(DataSet *dataset);
 
 #endif // INPUT_PARSER_H
@@ -1,11 +1,27 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "arena.h"
+#include "attribute_weights.h"
 #include "input_parser.h"
 #include "matching_engine.h"
 #include "solution_selector.h"
 #include "output_writer.h"
+#include "process_sharding.h"
+#include "checkpoint.h"
+#include "pairing.h"
+#include "score_analytics.h"
+#include "score_matrix.h"
+#include "stream_matcher.h"
+#include "synchronization.h"
 
 /**
  * @brief Displays usage instructions
@@ -13,12 +29,286 @@
  * @param program_name
  */
 void print_usage(const char *program_name) {
-    printf("Usage: %s <category> <file1> <file2>\n", program_name);
+    printf("Usage: %s <category> <file1> <file2> [options]\n", program_name);
     printf("Categories:\n");
     printf("  mentee_mentor     Match mentors and mentees (with capacity constraints)\n");
     printf("  participant_panel Match participants and panels/initiatives (no constraints)\n");
+    printf("Options:\n");
+    printf("  --workers <n>     Score in <n> forked worker processes sharing one score matrix\n");
+    printf("  --checkpoint <f>  Periodically save the run's state to <f>\n");
+    printf("  --checkpoint-interval <n>  Mentees assigned between solver checkpoints (default %d)\n",
+           DEFAULT_CHECKPOINT_INTERVAL);
+    printf("  --resume          Resume from the checkpoint (default %s) if it exists\n",
+           DEFAULT_CHECKPOINT_PATH);
+    printf("  --solver <name>   Assignment engine: sequential (default), bucketed or stable\n");
+    printf("  --result-store <f> Also write an indexed binary result file for fast lookups\n");
+    printf("  --deadline-ms <n> Stop after <n> ms and keep the best assignment found so far\n");
+    printf("  --stream          Match mentees from <file1> (- for stdin) as they arrive; matches go to stdout\n");
+    printf("  --follow          With --stream, keep reading <file1> as it grows until interrupted\n");
+    printf("  --weights <f>     Weight shared attributes by the Attribute,Weight rows of <f> (default weight %d)\n",
+           DEFAULT_ATTRIBUTE_WEIGHT);
+    printf("  --idf-weights     Weight shared attributes by how rare they are across both files\n");
+    printf("  --analytics-dir <d> Write score_distribution.csv and attribute_overlaps.csv into <d>\n");
 } // print_usage
 
+/**
+ * @brief Options that follow the positional arguments.
+ */
+typedef struct {
+    int num_workers;              // Worker processes for scoring (0 for in-process threads)
+    const char *checkpoint_path;  // Checkpoint file, or NULL when checkpointing is disabled
+    int checkpoint_interval;      // Mentees assigned between solver checkpoints
+    bool resume;                  // Resume from the last checkpoint if one exists
+    const char *result_store;     // Indexed binary result file, or NULL to skip it
+    SolverKind solver;            // Assignment engine for mentee_mentor
+    long deadline_ms;             // Time budget for scoring and solving (0 for none)
+    bool stream;                  // Match mentees online as they are read from <file1>
+    bool follow;                  // Keep reading a streamed <file1> past its end
+    const char *weights_path;     // Attribute weights file, or NULL
+    bool idf_weights;             // Derive attribute weights from both datasets
+    const char *analytics_dir;    // Directory for the score analytics files, or NULL to skip them
+} ProgramOptions;
+
+/**
+ * @brief Parses the optional flags that follow the positional arguments.
+ *
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @param options Pointer to the options structure to populate.
+ * @return true if all options were recognized, false otherwise.
+ */
+bool parse_options(int argc, char *argv[], ProgramOptions *options) {
+    *options = (ProgramOptions){.num_workers = 0,
+                                .checkpoint_path = NULL,
+                                .checkpoint_interval = DEFAULT_CHECKPOINT_INTERVAL,
+                                .resume = false,
+                                .result_store = NULL,
+                                .solver = SOLVER_SEQUENTIAL,
+                                .deadline_ms = 0,
+                                .stream = false,
+                                .follow = false,
+                                .weights_path = NULL,
+                                .idf_weights = false,
+                                .analytics_dir = NULL};
+
+    for (int i = 4; i < argc; i++) {
+        if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            options->num_workers = atoi(argv[++i]);
+            if (options->num_workers < 1) {
+                fprintf(stderr, "Error: --workers expects a positive number.\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            options->checkpoint_path = argv[++i];
+        } else if (strcmp(argv[i], "--checkpoint-interval") == 0 && i + 1 < argc) {
+            options->checkpoint_interval = atoi(argv[++i]);
+            if (options->checkpoint_interval < 1) {
+                fprintf(stderr, "Error: --checkpoint-interval expects a positive number.\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--result-store") == 0 && i + 1 < argc) {
+            options->result_store = argv[++i];
+        } else if (strcmp(argv[i], "--solver") == 0 && i + 1 < argc) {
+            const char *solver = argv[++i];
+            if (strcmp(solver, "sequential") == 0) {
+                options->solver = SOLVER_SEQUENTIAL;
+            } else if (strcmp(solver, "bucketed") == 0) {
+                options->solver = SOLVER_BUCKETED;
+            } else if (strcmp(solver, "stable") == 0) {
+                options->solver = SOLVER_STABLE;
+            } else {
+                fprintf(stderr, "Error: Unknown solver: %s\n", solver);
+                return false;
+            }
+        } else if (strcmp(argv[i], "--deadline-ms") == 0 && i + 1 < argc) {
+            options->deadline_ms = atol(argv[++i]);
+            if (options->deadline_ms < 1) {
+                fprintf(stderr, "Error: --deadline-ms expects a positive number.\n");
+                return false;
+            }
+        } else if (strcmp(argv[i], "--resume") == 0) {
+            options->resume = true;
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            options->stream = true;
+        } else if (strcmp(argv[i], "--follow") == 0) {
+            options->follow = true;
+        } else if (strcmp(argv[i], "--weights") == 0 && i + 1 < argc) {
+            options->weights_path = argv[++i];
+        } else if (strcmp(argv[i], "--idf-weights") == 0) {
+            options->idf_weights = true;
+        } else if (strcmp(argv[i], "--analytics-dir") == 0 && i + 1 < argc) {
+            options->analytics_dir = argv[++i];
+        } else {
+            fprintf(stderr, "Error: Unknown option: %s\n", argv[i]);
+            return false;
+        }
+    }
+
+    if (options->follow && !options->stream) {
+        fprintf(stderr, "Error: --follow requires --stream.\n");
+        return false;
+    }
+    if (options->weights_path && options->idf_weights) {
+        fprintf(stderr, "Error: --weights and --idf-weights cannot be combined.\n");
+        return false;
+    }
+    if (options->stream && options->idf_weights) {
+        fprintf(stderr, "Error: --idf-weights needs every mentee up front; use --weights with --stream.\n");
+        return false;
+    }
+    if (options->stream && (options->num_workers > 0 || options->checkpoint_path || options->resume ||
+                            options->result_store || options->analytics_dir || options->solver != SOLVER_SEQUENTIAL)) {
+        fprintf(stderr, "Error: --stream assigns mentees online and cannot be combined with --workers, "
+                        "--checkpoint, --resume, --result-store, --analytics-dir or a solver other than sequential.\n");
+        return false;
+    }
+
+    if (options->resume && !options->checkpoint_path) {
+        options->checkpoint_path = DEFAULT_CHECKPOINT_PATH;
+    }
+    return true;
+} // parse_options
+
+/**
+ * @brief State shared with the solver's checkpoint callback.
+ */
+typedef struct {
+    const char *path;        // Checkpoint file
+    Checkpoint *checkpoint;  // State of the current run
+} CheckpointContext;
+
+/**
+ * @brief Solver progress callback that persists the partial assignment.
+ *
+ * @param state Current solver state.
+ * @param context Pointer to the run's `CheckpointContext`.
+ */
+static void checkpoint_solver_progress(const SolverState *state, void *context) {
+    CheckpointContext *checkpoint_context = context;
+    checkpoint_context->checkpoint->stage = CHECKPOINT_SOLVING;
+    checkpoint_context->checkpoint->solver = *state;
+    save_solver_checkpoint(checkpoint_context->path, checkpoint_context->checkpoint);
+} // checkpoint_solver_progress
+
+/**
+ * @brief Describes the inputs and settings of a run for its checkpoints.
+ *
+ * @param options Program options.
+ * @param file1 Path to the first input file.
+ * @param file2 Path to the second input file.
+ * @param identity Pointer to the identity to be filled in.
+ * @return 1 on success, 0 if an input file cannot be read.
+ */
+int describe_run(const ProgramOptions *options, const char *file1, const char *file2, CheckpointIdentity *identity) {
+    *identity = (CheckpointIdentity){.solver = options->solver,
+                                     .weight_mode = options->weights_path ? WEIGHTS_FILE
+                                                    : options->idf_weights ? WEIGHTS_IDF
+                                                                           : WEIGHTS_NONE};
+    return fingerprint_file(file1, &identity->file1_fingerprint) &&
+           fingerprint_file(file2, &identity->file2_fingerprint) &&
+           (!options->weights_path || fingerprint_file(options->weights_path, &identity->weights_fingerprint));
+} // describe_run
+
+/**
+ * @brief Fills score analytics from an already computed matrix.
+ *
+ * @param dataset1 Pointer to the first dataset.
+ * @param dataset2 Pointer to the second dataset.
+ * @param compatibility_scores Pointer to the compatibility scores array.
+ * @param analytics Pointer to the analytics to be filled in.
+ */
+void analyze_scores(DataSet *dataset1, DataSet *dataset2, const int *compatibility_scores, ScoreAnalytics *analytics) {
+    if (init_score_analytics(analytics, dataset2->row_count)) {
+        analyze_score_matrix(analytics, compatibility_scores, dataset1->row_count, dataset2->row_count);
+        compute_attribute_overlaps(analytics, dataset1, dataset2);
+    }
+} // analyze_scores
+
+/**
+ * @brief Writes the score distribution and the attribute overlaps into a directory.
+ *
+ * The directory is created if it does not exist yet.
+ *
+ * @param directory Directory for `score_distribution.csv` and `attribute_overlaps.csv`.
+ * @param columns Dataset of mentors or panels.
+ * @param analytics Analytics of the score matrix.
+ * @return 1 on success, 0 on failure.
+ */
+int write_score_analytics(const char *directory, DataSet *columns, const ScoreAnalytics *analytics) {
+    if (mkdir(directory, 0777) != 0 && errno != EEXIST) {
+        perror("Failed to create analytics directory");
+        return 0;
+    }
+
+    char distribution_path[PATH_MAX];
+    char overlaps_path[PATH_MAX];
+    if (snprintf(distribution_path, sizeof(distribution_path), "%s/score_distribution.csv", directory) >= PATH_MAX ||
+        snprintf(overlaps_path, sizeof(overlaps_path), "%s/attribute_overlaps.csv", directory) >= PATH_MAX) {
+        fprintf(stderr, "Error: Analytics directory path is too long: %s\n", directory);
+        return 0;
+    }
+    return write_score_distribution(distribution_path, columns, analytics) &&
+           write_attribute_overlaps(overlaps_path, analytics);
+} // write_score_analytics
+
+/**
+ * @brief Computes the compatibility scores in-process or across worker processes.
+ *
+ * In-process scoring runs on a `PairingContext`, which gathers the score analytics
+ * during the same pass and writes straight into a matrix taken from the run's arena.
+ * Worker processes produce the matrix in shared memory, which is used as is, so the
+ * analytics are computed from it afterwards. Pairs not scored before `cancel` fires are 0.
+ *
+ * @param dataset1 Pointer to the first dataset.
+ * @param dataset2 Pointer to the second dataset.
+ * @param arena Arena of the run, which owns an in-process matrix.
+ * @param num_workers Number of worker processes, or 0 to score on a thread pool.
+ * @param weights Attribute weights, or NULL to count shared attributes.
+ * @param analytics Pointer to the analytics to be filled in, or NULL to skip them.
+ * @param cancel Token that stops scoring early (may be NULL).
+ * @return The score matrix, or NULL on failure.
+ */
+ScoreMatrix *score_datasets(DataSet *dataset1, DataSet *dataset2, Arena *arena, int num_workers, const AttributeWeights *weights, ScoreAnalytics *analytics, CancellationToken *cancel) {
+    if (num_workers > 0) {
+        ScoreMatrix *matrix = match_datasets_sharded_matrix(dataset1, dataset2, num_workers, weights, cancel);
+        if (matrix && analytics) analyze_scores(dataset1, dataset2, matrix->scores, analytics);
+        return matrix;
+    }
+
+    ScoreMatrix *matrix = score_matrix_create(arena, dataset1->row_count, dataset2->row_count);
+    PairingContext *context = pairing_create(0);
+    if (context) {
+        pairing_set_cancellation(context, cancel);
+        pairing_set_weights(context, weights);
+    }
+    if (!matrix || !context ||
+        !pairing_score_with_analytics(context, dataset1, dataset2, matrix->scores, analytics)) {
+        fprintf(stderr, "Error: Failed to compute compatibility scores.\n");
+        score_matrix_free(matrix);
+        matrix = NULL;
+    }
+    pairing_destroy(context);
+    return matrix;
+} // score_datasets
+
+/**
+ * @brief Builds the attribute weights requested by the options.
+ *
+ * @param options Program options.
+ * @param dataset1 Pointer to the first dataset, used for IDF weights (may be NULL otherwise).
+ * @param dataset2 Pointer to the second dataset, used for IDF weights (may be NULL otherwise).
+ * @param weights Pointer to the weights to be initialized and filled in; free them even on failure.
+ * @param active Set to `weights` when weights were requested, or to NULL to count shared attributes.
+ * @return 1 on success, 0 on failure.
+ */
+int build_weights(const ProgramOptions *options, const DataSet *dataset1, const DataSet *dataset2, AttributeWeights *weights, const AttributeWeights **active) {
+    init_attribute_weights(weights);
+    *active = options->weights_path || options->idf_weights ? weights : NULL;
+    if (options->weights_path) return load_attribute_weights(weights, options->weights_path);
+    if (options->idf_weights) return compute_idf_weights(weights, dataset1, dataset2);
+    return 1;
+} // build_weights
+
 /**
  * @brief Parses a dataset from a given file and handles errors.
  * 
@@ -36,76 +326,322 @@ DataSet *parse_dataset(const char *file_path, bool *success) {
 } // parse_dataset
 
 /**
- * @brief Frees allocated datasets and compatibility scores.
+ * @brief Frees allocated datasets, the score matrix and the run's arena.
  *
  * @param dataset1 Pointer to the first dataset.
  * @param dataset2 Pointer to the second dataset.
- * @param compatibility_scores Pointer to the compatibility scores array.
- * @param matches Pointer to the matches array.
+ * @param scores Pointer to the score matrix (may be NULL).
+ * @param arena Arena of the run, which also holds the matches.
  */
-void cleanup_resources(DataSet *dataset1, DataSet *dataset2, int *compatibility_scores, int *matches) {
-    free(compatibility_scores);
-    free(matches);
+void cleanup_resources(DataSet *dataset1, DataSet *dataset2, ScoreMatrix *scores, Arena *arena) {
+    score_matrix_free(scores);
+    free_arena(arena);
     free_dataset(dataset1);
     free_dataset(dataset2);
 } // cleanup_resources
 
+/**
+ * @brief Saves a checkpoint of the run if checkpointing is enabled.
+ *
+ * @param options Program options.
+ * @param checkpoint State of the current run.
+ * @param stage Stage that has just been completed.
+ */
+void checkpoint_stage(const ProgramOptions *options, Checkpoint *checkpoint, CheckpointStage stage) {
+    if (!options->checkpoint_path) return;
+    checkpoint->stage = stage;
+    if (save_checkpoint(options->checkpoint_path, checkpoint)) {
+        printf("Checkpoint saved to %s.\n", options->checkpoint_path);
+    }
+} // checkpoint_stage
+
+/**
+ * @brief Token that ends a stream when the process is interrupted.
+ */
+static CancellationToken *stream_cancel = NULL;
+
+/**
+ * @brief Signal handler that ends the stream at the next batch boundary.
+ */
+static void stop_stream(int signal_number) {
+    (void)signal_number;
+    request_cancellation(stream_cancel);
+} // stop_stream
+
+/**
+ * @brief Matches mentees read from a file or stdin as they arrive.
+ *
+ * Matches are written to stdout in the format of `output.csv`, so all progress
+ * and the final report go to stderr. The stream ends at the end of the input
+ * (unless following it), at the deadline, or on SIGINT/SIGTERM.
+ *
+ * @param options Program options.
+ * @param mentee_path Mentee CSV file, or "-" for stdin.
+ * @param mentor_path Mentor CSV file.
+ * @param deadline Token that ends the stream.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+int run_stream(const ProgramOptions *options, const char *mentee_path, const char *mentor_path, CancellationToken *deadline) {
+    fprintf(stderr, "Parsing input file: %s\n", mentor_path);
+    bool success;
+    DataSet *mentors = parse_csv(mentor_path, &success);
+    if (!success) {
+        fprintf(stderr, "Error: Failed to parse input file: %s\n", mentor_path);
+        return EXIT_FAILURE;
+    }
+
+    int fd = strcmp(mentee_path, "-") == 0 ? STDIN_FILENO : open(mentee_path, O_RDONLY);
+    if (fd < 0) {
+        perror("Error opening file");
+        free_dataset(mentors);
+        return EXIT_FAILURE;
+    }
+
+    // Interrupting the stream ends it like the deadline; without SA_RESTART a waiting reader wakes up
+    stream_cancel = deadline;
+    struct sigaction action = {.sa_handler = stop_stream};
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    AttributeWeights weights;
+    const AttributeWeights *active_weights;
+    if (!build_weights(options, NULL, mentors, &weights, &active_weights)) {
+        free_attribute_weights(&weights);
+        if (fd != STDIN_FILENO) close(fd);
+        free_dataset(mentors);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(stderr, "Streaming mentees from %s...\n", strcmp(mentee_path, "-") == 0 ? "stdin" : mentee_path);
+    StreamReport report;
+    StreamMatcher *matcher = stream_matcher_create(mentors, active_weights, 0);
+    free_attribute_weights(&weights);
+    int ok = matcher && stream_mentees(matcher, fd, options->follow, stdout, deadline, &report);
+    if (ok) {
+        fprintf(stderr, "Streamed %ld mentees in %.3f s (%.0f mentees/s), %ld assigned, total score %ld.\n",
+                report.rows, report.seconds, report.rows_per_second, report.assigned, report.total_score);
+        fprintf(stderr, "Latency per mentee: p50 %.3f ms, p99 %.3f ms, max %.3f ms.\n",
+                report.p50_latency_ms, report.p99_latency_ms, report.max_latency_ms);
+    } else {
+        fprintf(stderr, "Error: Streaming stopped on a failure.\n");
+    }
+
+    stream_matcher_destroy(matcher);
+    if (fd != STDIN_FILENO) close(fd);
+    free_dataset(mentors);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+} // run_stream
+
 int main(int argc, char *argv[]) {
-    if (argc != 4) {
+    ProgramOptions options;
+    if (argc < 4 || !parse_options(argc, argv, &options)) {
         print_usage(argv[0]);
         return EXIT_FAILURE;
     }
 
+    // The deadline covers the whole run, starting now
+    CancellationToken deadline;
+    init_cancellation_token(&deadline);
+    if (options.deadline_ms > 0) set_cancellation_deadline(&deadline, options.deadline_ms);
+
     const char *category = argv[1];
     const char *file1 = argv[2];
     const char *file2 = argv[3];
     bool success1, success2;
 
-    DataSet *dataset1 = parse_dataset(file1, &success1);
-    if (!success1) return EXIT_FAILURE;
+    if (strcmp(category, "mentee_mentor") != 0 && strcmp(category, "participant_panel") != 0) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (options.stream) {
+        if (strcmp(category, "mentee_mentor") != 0) {
+            fprintf(stderr, "Error: --stream is only available for mentee_mentor.\n");
+            return EXIT_FAILURE;
+        }
+        return run_stream(&options, file1, file2, &deadline);
+    }
 
-    DataSet *dataset2 = parse_dataset(file2, &success2);
-    if (!success2) {
-        free_dataset(dataset1);
+    // Checkpoints record what the run reads, so a resume cannot mix inputs or settings
+    Checkpoint checkpoint = {.category = (char *)category};
+    if (options.checkpoint_path && !describe_run(&options, file1, file2, &checkpoint.identity)) {
         return EXIT_FAILURE;
     }
 
-    int *compatibility_scores = NULL;
+    // Pick up the last consistent checkpoint when resuming
+    Checkpoint *resumed = NULL;
+    if (options.resume) {
+        bool loaded;
+        resumed = load_checkpoint(options.checkpoint_path, &loaded);
+        if (!loaded) return EXIT_FAILURE;
+        const char *mismatch = NULL;
+        if (resumed && strcmp(resumed->category, category) != 0) {
+            mismatch = "another category";
+        } else if (resumed && (resumed->identity.file1_fingerprint != checkpoint.identity.file1_fingerprint ||
+                               resumed->identity.file2_fingerprint != checkpoint.identity.file2_fingerprint)) {
+            mismatch = "other input files";
+        } else if (resumed && resumed->identity.solver != checkpoint.identity.solver) {
+            mismatch = "another --solver";
+        } else if (resumed && (resumed->identity.weight_mode != checkpoint.identity.weight_mode ||
+                               resumed->identity.weights_fingerprint != checkpoint.identity.weights_fingerprint)) {
+            mismatch = "other attribute weights";
+        }
+        if (mismatch) {
+            fprintf(stderr, "Error: Checkpoint %s was created for %s; rerun with the original arguments or without --resume.\n",
+                    options.checkpoint_path, mismatch);
+            free_checkpoint(resumed);
+            return EXIT_FAILURE;
+        }
+        if (resumed) {
+            printf("Resuming from checkpoint %s.\n", options.checkpoint_path);
+        } else {
+            printf("No checkpoint found at %s, starting from the beginning.\n", options.checkpoint_path);
+        }
+    }
+
+    CheckpointStage resumed_stage = resumed ? resumed->stage : CHECKPOINT_NONE;
+    DataSet *dataset1;
+    DataSet *dataset2;
+    ScoreMatrix *scores = NULL;
     int *matches = NULL;
 
+    // Everything allocated for the run past parsing comes from one arena
+    Arena run_arena;
+    init_arena(&run_arena, 0);
+
+    if (resumed) {
+        dataset1 = resumed->dataset1;
+        dataset2 = resumed->dataset2;
+        scores = score_matrix_wrap(resumed->compatibility_scores, dataset1->row_count, dataset2->row_count,
+                                   score_matrix_free_storage);
+        checkpoint.run_id = resumed->run_id; // Solver state continues the loaded checkpoint
+        resumed->dataset1 = NULL;
+        resumed->dataset2 = NULL;
+        resumed->compatibility_scores = NULL;
+    } else {
+        dataset1 = parse_dataset(file1, &success1);
+        if (!success1) return EXIT_FAILURE;
+
+        dataset2 = parse_dataset(file2, &success2);
+        if (!success2) {
+            free_dataset(dataset1);
+            return EXIT_FAILURE;
+        }
+    }
+
+    checkpoint.dataset1 = dataset1;
+    checkpoint.dataset2 = dataset2;
+
+    // Run the matching process; analytics are gathered only when a file needs them
+    ScoreAnalytics analytics = {0};
+    ScoreAnalytics *wanted_analytics =
+        options.analytics_dir || strcmp(category, "participant_panel") == 0 ? &analytics : NULL;
+    printf("Starting matching process for %s...\n", category);
+    bool scoring_cut_short = false;
+    if (resumed_stage < CHECKPOINT_SCORED) {
+        AttributeWeights weights;
+        const AttributeWeights *active_weights;
+        if (!build_weights(&options, dataset1, dataset2, &weights, &active_weights)) {
+            free_attribute_weights(&weights);
+            free_checkpoint(resumed);
+            cleanup_resources(dataset1, dataset2, scores, &run_arena);
+            return EXIT_FAILURE;
+        }
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        scores = score_datasets(dataset1, dataset2, &run_arena, options.num_workers, active_weights, wanted_analytics, &deadline);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        free_attribute_weights(&weights);
+        if (!scores) {
+            free_score_analytics(&analytics);
+            free_checkpoint(resumed);
+            cleanup_resources(dataset1, dataset2, scores, &run_arena);
+            return EXIT_FAILURE;
+        }
+        checkpoint.compatibility_scores = scores->scores;
+        scoring_cut_short = is_cancelled(&deadline);
+        if (scoring_cut_short) {
+            printf("Deadline reached while scoring; pairs not scored yet count as 0, and the solver runs to completion on the rest.\n");
+        } else {
+            checkpoint_stage(&options, &checkpoint, CHECKPOINT_SCORED);
+        }
+
+        if (strcmp(category, "mentee_mentor") == 0 && options.deadline_ms == 0 && !active_weights) {
+            // Compare the scoring just done with a non-threaded estimate (skipped under a deadline or weights)
+            printf("Measuring threading performance...\n");
+            measure_threading_performance(dataset1, dataset2,
+                                          (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9,
+                                          options.num_workers);
+            printf("Threading performance measured.\n\n");
+        }
+    } else {
+        if (!scores) {
+            fprintf(stderr, "Error: Failed to restore the score matrix of checkpoint %s.\n", options.checkpoint_path);
+            free_checkpoint(resumed);
+            cleanup_resources(dataset1, dataset2, scores, &run_arena);
+            return EXIT_FAILURE;
+        }
+        checkpoint.compatibility_scores = scores->scores;
+        if (wanted_analytics) analyze_scores(dataset1, dataset2, scores->scores, wanted_analytics);
+    }
+
     if (strcmp(category, "mentee_mentor") == 0) {
-        // Measure threading performance
-        printf("Measuring threading performance...\n");
-        measure_threading_performance(dataset1, dataset2, compatibility_scores);
-        printf("Threading performance measured.\n\n");
-
-        // Run the matching process
-        printf("Starting matching process for mentee_mentor...\n");
-        match_datasets(dataset1, dataset2, &compatibility_scores);
-        select_optimal_matches(dataset1, dataset2, compatibility_scores, &matches);
-        printf("Matching completed.\n\n");
-    } else if (strcmp(category, "participant_panel") == 0) {
-        printf("Starting matching process for participant_panel...\n");
-        match_datasets(dataset1, dataset2, &compatibility_scores);
-        printf("Matching completed.\n\n");
-
-        // Analyze panel popularity
-        analyze_panel_popularity("panel_popularity.csv", dataset2, compatibility_scores, dataset1->row_count);
+        // A deadline that already passed while scoring would leave every mentee unassigned, so the
+        // solver then runs without it, and its progress is not saved against an incomplete matrix
+        SolverReport report = {0};
+        CheckpointContext checkpoint_context = {.path = options.checkpoint_path, .checkpoint = &checkpoint};
+        SolverOptions solver_options = {
+            .resume_from = resumed_stage == CHECKPOINT_SOLVING ? &resumed->solver : NULL,
+            .checkpoint_interval = options.checkpoint_interval,
+            .on_checkpoint = options.checkpoint_path && !scoring_cut_short ? checkpoint_solver_progress : NULL,
+            .context = &checkpoint_context,
+            .cancel = scoring_cut_short ? NULL : &deadline,
+            .improve = options.deadline_ms > 0 && !scoring_cut_short,
+            .report = &report,
+            .arena = &run_arena};
+        if (options.solver == SOLVER_BUCKETED) {
+            select_bucketed_matches(dataset1, dataset2, scores->scores, &matches, &solver_options);
+        } else if (options.solver == SOLVER_STABLE) {
+            select_stable_matches(dataset1, dataset2, scores->scores, &matches, &solver_options);
+        } else {
+            select_optimal_matches_with_options(dataset1, dataset2, scores->scores, &matches, &solver_options);
+        }
+        if (!matches) {
+            fprintf(stderr, "Error: The solver could not produce an assignment.\n");
+            free_score_analytics(&analytics);
+            free_checkpoint(resumed);
+            cleanup_resources(dataset1, dataset2, scores, &run_arena);
+            return EXIT_FAILURE;
+        }
+        printf("Total score: %ld of at most %ld (gap %.2f%%), %d mentees assigned.\n",
+               report.objective, report.upper_bound, 100.0 * report.gap, report.assigned);
+        if (!report.completed) printf("Deadline reached; keeping the best assignment found so far.\n");
+    }
+    printf("Matching completed.\n\n");
+
+    // Write the analytics gathered while scoring
+    if (strcmp(category, "participant_panel") == 0) {
+        write_panel_popularity("panel_popularity.csv", dataset2, &analytics);
         printf("Panel popularity analysis written to panel_popularity.csv.\n");
-    } else {
-        print_usage(argv[0]);
-        cleanup_resources(dataset1, dataset2, compatibility_scores, matches);
-        return EXIT_FAILURE;
     }
+    if (options.analytics_dir && write_score_analytics(options.analytics_dir, dataset2, &analytics)) {
+        printf("Score analytics written to %s.\n", options.analytics_dir);
+    }
+    free_score_analytics(&analytics);
+    free_checkpoint(resumed);
 
     // Write results to the output file
-    if (!write_output_file("output.csv", dataset1, dataset2, matches, compatibility_scores, strcmp(category, "participant_panel") == 0)) {
+    if (!write_output_file("output.csv", dataset1, dataset2, matches, scores->scores, strcmp(category, "participant_panel") == 0, options.result_store)) {
         fprintf(stderr, "Error writing output file.\n");
-        cleanup_resources(dataset1, dataset2, compatibility_scores, matches);
+        cleanup_resources(dataset1, dataset2, scores, &run_arena);
         return EXIT_FAILURE;
     }
 
-    cleanup_resources(dataset1, dataset2, compatibility_scores, matches);
+    // The run is complete, so there is nothing left to resume
+    if (options.checkpoint_path) remove_checkpoint(options.checkpoint_path);
+
+    cleanup_resources(dataset1, dataset2, scores, &run_arena);
 
     printf("Program completed successfully.\n");
     return EXIT_SUCCESS;
@@ -61,6 +61,31 @@ int calculate_score(DataRow *a, DataRow *b) {
     return score;
 } // calculate_score
 
+/**
+ * @brief Calculate the weighted compatibility score between two individuals.
+ *
+ * Like `calculate_score`, but each matching attribute pair contributes the weight
+ * of the attribute instead of 1. With every weight at 1 both scores are equal.
+ *
+ * @param a Pointer to the first DataRow (mentee/participant).
+ * @param b Pointer to the second DataRow (mentor/panel).
+ * @param weights Pointer to the attribute weights.
+ * @return The weighted compatibility score as an integer.
+ */
+int calculate_weighted_score(DataRow *a, DataRow *b, const AttributeWeights *weights) {
+    if (!a || !b) return 0; // Null check
+
+    int score = 0;
+    for (int i = 0; i < a->attributes_count; i++) {
+        int matching = 0;
+        for (int j = 0; j < b->attributes_count; j++) {
+            matching += strcmp(a->attributes[i], b->attributes[j]) == 0;
+        }
+        if (matching) score += matching * attribute_weight(weights, a->attributes[i]);
+    }
+    return score;
+} // calculate_weighted_score
+
 /**
  * @brief Thread function to compute compatibility scores for an individual.
  *
@@ -8,16 +8,19 @@
  *
  * Dependencies:
  * - `input_parser.h`: Defines the `DataSet` and `DataRow` structures used for data representation.
+ * - `attribute_weights.h`: Defines the `AttributeWeights` used for weighted scores.
  * - `synchronization.h`: Provides functionality for mutexes and shared resource synchronization.
  */
 #ifndef MATCHING_ENGINE_H
 #define MATCHING_ENGINE_H
 
+#include "attribute_weights.h"
 #include "input_parser.h"
 #include "synchronization.h"
 
 // Function Declarations
 int calculate_score(DataRow *a, DataRow *b);
+int calculate_weighted_score(DataRow *a, DataRow *b, const AttributeWeights *weights);
 void match_datasets(DataSet *dataset1, DataSet *dataset2, int **compatibility_scores);
 
 #endif // MATCHING_ENGINE_H
\ No newline at end of file
@@ -10,22 +10,25 @@
  * - `output_writer.h`: Declares the interface for this functionality.
  * - `input_parser.h`: Provides definitions for `DataSet` and `DataRow`.
  * - `solution_selector.h`: Provides the matching indices.
- * - `matching_engine.h`: Provides the `calculate_score` function to compute compatibility scores.
+ * - `result_store.h`: Writes the optional indexed binary copy of the results.
+ * - `score_analytics.h`: Counts and writes panel popularity.
  */
 #include <stdio.h>
 #include <stdlib.h>
 #include "output_writer.h"
 #include "input_parser.h"
 #include "solution_selector.h"
-#include "matching_engine.h"
+#include "result_store.h"
+#include "score_analytics.h"
 
 /**
  * @brief Writes mentee-to-mentor matches to the output file.
  *
  * Handles the `mentee_mentor` category, writing the best matches for each mentee
- * based on the provided matches array and compatibility scores.
+ * based on the provided matches array. Scores are read from the matrix computed
+ * during matching rather than recomputed.
  */
-static void write_mentee_mentor_matches(FILE *file, DataSet *mentees, DataSet *mentors, int *matches) {
+static void write_mentee_mentor_matches(FILE *file, DataSet *mentees, DataSet *mentors, int *matches, const int *compatibility_scores) {
     fprintf(file, "Mentee,Mentor,Compatibility Score\n");
 
     for (int i = 0; i < mentees->row_count; i++) {
@@ -34,7 +37,7 @@ static void write_mentee_mentor_matches(FILE *file, DataSet *mentees, DataSet *m
             fprintf(file, "%s,%s,%d\n",
                     mentees->rows[i].name,
                     mentors->rows[match_index].name,
-                    calculate_score(&mentees->rows[i], &mentors->rows[match_index]));
+                    compatibility_scores[(size_t)i * mentors->row_count + match_index]);
         } else { // No valid match
             fprintf(file, "%s,No Match,0\n", mentees->rows[i].name);
         }
@@ -47,7 +50,7 @@ static void write_mentee_mentor_matches(FILE *file, DataSet *mentees, DataSet *m
  * Handles the `participant_panel` category, writing all matches where the compatibility
  * score is greater than zero, without restrictions.
  */
-static void write_participant_panel_matches(FILE *file, DataSet *participants, DataSet *panels, int *compatibility_scores) {
+static void write_participant_panel_matches(FILE *file, DataSet *participants, DataSet *panels, const int *compatibility_scores) {
     fprintf(file, "Participant,Panel,Compatibility Score\n");
 
     for (int i = 0; i < participants->row_count; i++) {
@@ -77,9 +80,10 @@ static void write_participant_panel_matches(FILE *file, DataSet *participants, D
  * @param matches Array of indices representing the best matches for each mentee or participant (optional for `participant_panel`).
  * @param compatibility_scores Compatibility scores array for all mentee/panel pairings.
  * @param is_participant_panel Boolean flag to indicate `participant_panel` mode.
+ * @param store_filename Path to an indexed binary result store to write as well, or NULL to skip it.
  * @return 1 on success, 0 on failure (e.g., file write error).
  */
-int write_output_file(const char *filename, DataSet *dataset1, DataSet *dataset2, int *matches, int *compatibility_scores, bool is_participant_panel) {
+int write_output_file(const char *filename, DataSet *dataset1, DataSet *dataset2, int *matches, const int *compatibility_scores, bool is_participant_panel, const char *store_filename) {
     FILE *file = fopen(filename, "w");
     if (!file) {
         perror("Failed to open output file");
@@ -89,10 +93,14 @@ int write_output_file(const char *filename, DataSet *dataset1, DataSet *dataset2
     if (is_participant_panel) {
         write_participant_panel_matches(file, dataset1, dataset2, compatibility_scores);
     } else {
-        write_mentee_mentor_matches(file, dataset1, dataset2, matches);
+        write_mentee_mentor_matches(file, dataset1, dataset2, matches, compatibility_scores);
     }
 
     fclose(file);
+
+    if (store_filename) {
+        return write_result_store(store_filename, dataset1, dataset2, matches, compatibility_scores, is_participant_panel);
+    }
     return 1;
 } // write_output_file
 
@@ -100,39 +108,20 @@ int write_output_file(const char *filename, DataSet *dataset1, DataSet *dataset2
  * @brief Analyzes panel popularity by counting matches for each panel.
  *
  * This function counts how many participants were matched to each panel
- * and writes the results to a CSV file.
+ * and writes the results to a CSV file. Callers that score through a
+ * `PairingContext` get the same counts for free from `pairing_score_with_analytics`
+ * and can call `write_panel_popularity` directly instead.
  *
  * @param filename Path to the output file for panel popularity analysis.
  * @param mentors Dataset of panels/initiatives.
  * @param compatibility_scores Array of compatibility scores between participants and panels.
  * @param num_participants Number of participants.
  */
-void analyze_panel_popularity(const char *filename, DataSet *mentors, int *compatibility_scores, int num_participants) {
-    int *panel_counts = calloc(mentors->row_count, sizeof(int));
-
-    // Count matches for each panel
-    for (int i = 0; i < num_participants; i++) {
-        for (int j = 0; j < mentors->row_count; j++) {
-            int score = compatibility_scores[i * mentors->row_count + j];
-            if (score > 0) {
-                panel_counts[j]++;
-            }
-        }
-    }
-
-    // Write results to CSV
-    FILE *file = fopen(filename, "w");
-    if (!file) {
-        perror("Failed to open panel popularity file");
-        free(panel_counts);
-        return;
+void analyze_panel_popularity(const char *filename, DataSet *mentors, const int *compatibility_scores, int num_participants) {
+    ScoreAnalytics analytics = {0};
+    if (init_score_analytics(&analytics, mentors->row_count)) {
+        analyze_score_matrix(&analytics, compatibility_scores, num_participants, mentors->row_count);
+        write_panel_popularity(filename, mentors, &analytics);
     }
-
-    fprintf(file, "Panel,Number of Matches\n");
-    for (int i = 0; i < mentors->row_count; i++) {
-        fprintf(file, "%s,%d\n", mentors->rows[i].name, panel_counts[i]);
-    }
-
-    fclose(file);
-    free(panel_counts);
+    free_score_analytics(&analytics);
 } // analyze_panel_popularity
@@ -18,7 +18,7 @@
 #include "solution_selector.h"
 
 // Declare Function
-int write_output_file(const char *filename, DataSet *mentees, DataSet *mentors, int *matches, int *compatibility_scores, bool is_participant_panel);
-void analyze_panel_popularity(const char *filename, DataSet *mentors, int *compatibility_scores, int num_participants);
+int write_output_file(const char *filename, DataSet *mentees, DataSet *mentors, int *matches, const int *compatibility_scores, bool is_participant_panel, const char *store_filename);
+void analyze_panel_popularity(const char *filename, DataSet *mentors, const int *compatibility_scores, int num_participants);
 
 #endif
\ No newline at end of file
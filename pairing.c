@@ -0,0 +1,509 @@
+/**
+ * @file pairing.c
+ * @brief Embeddable matching context built on a thread pool and interned attributes.
+ *
+ * The context interns the attributes of both datasets into flat integer arrays,
+ * scores them on its worker pool and runs the capacity-aware greedy assignment,
+ * producing the same scores and matches as `match_datasets` and
+ * `select_optimal_matches`. All working memory is owned by the context and
+ * reused across calls. An optional cancellation token bounds both scoring and
+ * matching; scoring tasks that see it fire zero their rows and return, so the
+ * pool is immediately ready for the next call. Optional attribute weights select
+ * a weighted variant of the scoring kernel; both variants are generated from one
+ * macro so the unweighted path stays a plain count.
+ *
+ * Dependencies:
+ * - `pairing.h`: Declares the interface for this functionality.
+ * - `thread_pool.h`: Provides the worker pool used for scoring.
+ * - `attribute_dictionary.h`: Interns attribute strings into integer ids.
+ * - `attribute_weights.h`: Looks up the weight of each interned attribute.
+ * - `solution_selector.h`: Provides the sequential and bucketed assignment engines.
+ * - `output_writer.h`: Writes results when file output is requested.
+ * - `score_analytics.h`: Per-worker analytics accumulated while scoring.
+ * - `stable_matching.h`: Provides the stable-matching engine, run on the same pool.
+ */
+#include "pairing.h"
+#include "attribute_dictionary.h"
+#include "attribute_weights.h"
+#include "output_writer.h"
+#include "score_analytics.h"
+#include "solution_selector.h"
+#include "stable_matching.h"
+#include "thread_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define ROWS_PER_TASK 16 // Rows of the first dataset scored by one pool task
+
+/**
+ * @brief Attributes of a dataset as interned ids in CSR form.
+ *
+ * The ids of row `i` are `ids[offsets[i]]` to `ids[offsets[i + 1] - 1]`.
+ */
+typedef struct {
+    int *offsets;
+    size_t offsets_capacity;
+    int *ids;
+    size_t ids_capacity;
+} InternedRows;
+
+struct PairingContext {
+    ThreadPool *pool;
+    AttributeDictionary dictionary;
+    InternedRows rows1;             // First dataset (mentees or participants)
+    InternedRows rows2;             // Second dataset (mentors or panels)
+    int *scores;                    // Context-owned score matrix
+    size_t scores_capacity;
+    SolverKind solver;              // Engine used by `pairing_match`
+    int *capacity_remaining;        // Solver scratch space
+    size_t capacity_remaining_capacity;
+    BucketScratch buckets;          // Scratch space of the bucketed engine
+    StableScratch stable;           // Scratch space of the stable-matching engine
+    ScoreAnalytics *worker_analytics; // Per-worker partial analytics, merged after scoring
+    const int *last_scores;         // Matrix filled by the most recent scoring call
+    int last_row_count;             // Dimensions of `last_scores`
+    int last_column_count;
+    CancellationToken *cancel;      // Bounds scoring and matching, or NULL
+    const AttributeWeights *weights; // Attribute weights, or NULL to count shared attributes
+    int *id_weights;                // Weight of each interned id
+    size_t id_weights_capacity;
+    SolverReport report;            // Quality of the most recent `pairing_match` result
+};
+
+/**
+ * @brief Arguments shared by every scoring task of a batch.
+ */
+typedef struct {
+    const InternedRows *rows1;
+    const InternedRows *rows2;
+    int n;
+    int m;
+    int *compatibility_scores;
+    const int *weights;               // Weight of each interned id, or NULL when unweighted
+    ScoreAnalytics *worker_analytics; // Per-worker counters, or NULL when not requested
+    CancellationToken *cancel;        // Checked before each row, or NULL
+} ScoreBatch;
+
+/**
+ * @brief Grows a buffer so it can hold at least `count` elements.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+static int reserve_buffer(void **buffer, size_t *capacity, size_t count, size_t element_size) {
+    if (count <= *capacity) return 1;
+
+    size_t new_capacity = *capacity ? *capacity : 64;
+    while (new_capacity < count) new_capacity *= 2;
+    void *grown = realloc(*buffer, new_capacity * element_size);
+    if (!grown) {
+        perror("Failed to allocate memory for pairing context");
+        return 0;
+    }
+    *buffer = grown;
+    *capacity = new_capacity;
+    return 1;
+} // reserve_buffer
+
+/**
+ * @brief Interns the attributes of every row of a dataset.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+static int intern_rows(PairingContext *context, const DataSet *dataset, InternedRows *rows) {
+    size_t total = 0;
+    for (int i = 0; i < dataset->row_count; i++) total += dataset->rows[i].attributes_count;
+
+    if (!reserve_buffer((void **)&rows->offsets, &rows->offsets_capacity, dataset->row_count + 1, sizeof(int)) ||
+        !reserve_buffer((void **)&rows->ids, &rows->ids_capacity, total, sizeof(int))) {
+        return 0;
+    }
+
+    int k = 0;
+    for (int i = 0; i < dataset->row_count; i++) {
+        rows->offsets[i] = k;
+        for (int a = 0; a < dataset->rows[i].attributes_count; a++) {
+            int id = intern_attribute(&context->dictionary, dataset->rows[i].attributes[a]);
+            if (id == -1) return 0;
+            rows->ids[k++] = id;
+        }
+    }
+    rows->offsets[dataset->row_count] = k;
+    return 1;
+} // intern_rows
+
+/**
+ * @brief Defines a kernel that scores two interned rows.
+ *
+ * `ROW_WEIGHT(id)` is the contribution of one matching pair of attribute `id`. It
+ * multiplies the number of matches of each attribute of the first row, so the inner
+ * loop stays a branch-free count in every variant; the unweighted variant passes the
+ * constant 1, which leaves the plain counting loop with no weight loads.
+ */
+#define DEFINE_INTERNED_KERNEL(name, ROW_WEIGHT)                                                       \
+    static inline int name(const int *a, int a_count, const int *b, int b_count, const int *weights) { \
+        (void)weights;                                                                                 \
+        int score = 0;                                                                                 \
+        for (int i = 0; i < a_count; i++) {                                                            \
+            int matching = 0;                                                                          \
+            for (int j = 0; j < b_count; j++) {                                                        \
+                matching += a[i] == b[j];                                                              \
+            }                                                                                          \
+            score += matching * ROW_WEIGHT(a[i]);                                                      \
+        }                                                                                              \
+        return score;                                                                                  \
+    }
+
+#define UNIT_WEIGHT(id) 1
+#define ID_WEIGHT(id) weights[id]
+
+// Equivalent to `calculate_score` and `calculate_weighted_score` on the original strings
+DEFINE_INTERNED_KERNEL(score_interned, UNIT_WEIGHT)
+DEFINE_INTERNED_KERNEL(score_interned_weighted, ID_WEIGHT)
+
+/**
+ * @brief Defines a pool task that scores a block of `ROWS_PER_TASK` rows with `KERNEL`.
+ *
+ * Each weight mode gets its own task, so the kernel is inlined and the mode is chosen
+ * once per batch rather than per pair.
+ */
+#define DEFINE_SCORE_ROWS_TASK(name, KERNEL)                                                                 \
+    static void name(void *arg, int task_index, int worker_index) {                                          \
+        ScoreBatch *batch = arg;                                                                             \
+        ScoreAnalytics *analytics = batch->worker_analytics ? &batch->worker_analytics[worker_index] : NULL; \
+        int first = task_index * ROWS_PER_TASK;                                                              \
+        int last = first + ROWS_PER_TASK < batch->n ? first + ROWS_PER_TASK : batch->n;                      \
+                                                                                                             \
+        for (int i = first; i < last; i++) {                                                                 \
+            int *out = batch->compatibility_scores + (size_t)i * batch->m;                                   \
+            if (is_cancelled(batch->cancel)) {                                                               \
+                /* Unscored pairs count as no overlap */                                                     \
+                memset(out, 0, (size_t)(last - i) * batch->m * sizeof(int));                                 \
+                return;                                                                                      \
+            }                                                                                                \
+                                                                                                             \
+            const int *a = batch->rows1->ids + batch->rows1->offsets[i];                                     \
+            int a_count = batch->rows1->offsets[i + 1] - batch->rows1->offsets[i];                           \
+            for (int j = 0; j < batch->m; j++) {                                                             \
+                out[j] = KERNEL(a, a_count, batch->rows2->ids + batch->rows2->offsets[j],                    \
+                                batch->rows2->offsets[j + 1] - batch->rows2->offsets[j], batch->weights);    \
+                if (analytics) record_score(analytics, j, out[j]);                                           \
+            }                                                                                                \
+        }                                                                                                    \
+    }
+
+DEFINE_SCORE_ROWS_TASK(score_rows_task, score_interned)
+DEFINE_SCORE_ROWS_TASK(score_rows_weighted_task, score_interned_weighted)
+
+/**
+ * @brief Looks up the weight of every interned attribute.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+static int resolve_weights(PairingContext *context) {
+    int count = context->dictionary.count;
+    if (!reserve_buffer((void **)&context->id_weights, &context->id_weights_capacity, count, sizeof(int))) {
+        return 0;
+    }
+    for (int id = 0; id < count; id++) {
+        context->id_weights[id] = attribute_weight(context->weights, attribute_name(&context->dictionary, id));
+    }
+    return 1;
+} // resolve_weights
+
+/**
+ * @brief Creates a reusable matching context.
+ *
+ * @param num_threads Number of worker threads, or 0 to use one per online CPU.
+ * @return Pointer to the context, or NULL on failure.
+ */
+PairingContext *pairing_create(int num_threads) {
+    if (num_threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = cpus > 0 ? (int)cpus : 1;
+    }
+
+    PairingContext *context = calloc(1, sizeof(PairingContext));
+    if (!context) {
+        perror("Failed to allocate memory for pairing context");
+        return NULL;
+    }
+
+    context->pool = thread_pool_create(num_threads);
+    if (!context->pool) {
+        free(context);
+        return NULL;
+    }
+    init_attribute_dictionary(&context->dictionary);
+    return context;
+} // pairing_create
+
+/**
+ * @brief Destroys a context, stopping its threads and freeing its buffers.
+ *
+ * @param context Pointer to the context to be destroyed.
+ */
+void pairing_destroy(PairingContext *context) {
+    if (!context) return;
+
+    free_attribute_dictionary(&context->dictionary);
+    free(context->rows1.offsets);
+    free(context->rows1.ids);
+    free(context->rows2.offsets);
+    free(context->rows2.ids);
+    free(context->scores);
+    free(context->capacity_remaining);
+    free(context->id_weights);
+    free_bucket_scratch(&context->buckets);
+    free_stable_scratch(&context->stable);
+    if (context->worker_analytics) {
+        for (int w = 0; w < thread_pool_size(context->pool); w++) {
+            free_score_analytics(&context->worker_analytics[w]);
+        }
+        free(context->worker_analytics);
+    }
+    thread_pool_destroy(context->pool);
+    free(context);
+} // pairing_destroy
+
+/**
+ * @brief Selects the assignment engine used by `pairing_match`.
+ *
+ * @param context Pointer to the context.
+ * @param solver Engine to use (`SOLVER_SEQUENTIAL` by default).
+ */
+void pairing_set_solver(PairingContext *context, SolverKind solver) {
+    context->solver = solver;
+} // pairing_set_solver
+
+/**
+ * @brief Bounds later scoring and matching calls with a cancellation token.
+ *
+ * Once the token fires, scoring stops at the next row and leaves the remaining
+ * pairs at 0, and matching returns the best feasible assignment found so far.
+ * When the token has a deadline, `pairing_match` also spends the time left on
+ * `improve_assignment`. Both calls still succeed; check `is_cancelled` or the
+ * `completed` flag of `pairing_report` to tell whether they finished.
+ *
+ * @param context Pointer to the context.
+ * @param cancel Token that must outlive its use by the context, or NULL to remove it.
+ */
+void pairing_set_cancellation(PairingContext *context, CancellationToken *cancel) {
+    context->cancel = cancel;
+} // pairing_set_cancellation
+
+/**
+ * @brief Weights the attributes in later scoring calls.
+ *
+ * A shared attribute then contributes its weight to the score of a pair instead of 1.
+ * Without weights, scoring runs a kernel that only counts shared attributes.
+ *
+ * @param context Pointer to the context.
+ * @param weights Weights that must outlive their use by the context and stay unchanged,
+ *                or NULL to count shared attributes.
+ */
+void pairing_set_weights(PairingContext *context, const AttributeWeights *weights) {
+    context->weights = weights;
+} // pairing_set_weights
+
+/**
+ * @brief Computes the compatibility score matrix of two datasets.
+ *
+ * @param context Pointer to the context.
+ * @param dataset1 Pointer to the first dataset (e.g., mentees or participants).
+ * @param dataset2 Pointer to the second dataset (e.g., mentors or panels).
+ * @param compatibility_scores Caller buffer of `n * m` scores, or NULL to keep the
+ *                             matrix in the context (see `pairing_scores`).
+ * @return 1 on success, 0 on failure.
+ */
+int pairing_score(PairingContext *context, const DataSet *dataset1, const DataSet *dataset2, int *compatibility_scores) {
+    return pairing_score_with_analytics(context, dataset1, dataset2, compatibility_scores, NULL);
+} // pairing_score
+
+/**
+ * @brief Computes the score matrix and its analytics in a single pass.
+ *
+ * Each worker accumulates popularity counts and score histograms for the rows it
+ * scores into its own counters, which are merged once scoring has finished. The
+ * attribute overlap ranking is derived from the frequencies of the ids interned for
+ * scoring, without a pass over the matrix. If scoring is cancelled, the counters cover only the scored rows.
+ *
+ * @param context Pointer to the context.
+ * @param dataset1 Pointer to the first dataset (e.g., mentees or participants).
+ * @param dataset2 Pointer to the second dataset (e.g., mentors or panels).
+ * @param compatibility_scores Caller buffer of `n * m` scores, or NULL to keep the
+ *                             matrix in the context (see `pairing_scores`).
+ * @param analytics Zero-initialized or previously used analytics to fill in (may be NULL).
+ * @return 1 on success, 0 on failure.
+ */
+int pairing_score_with_analytics(PairingContext *context, const DataSet *dataset1, const DataSet *dataset2, int *compatibility_scores, ScoreAnalytics *analytics) {
+    if (!context || !dataset1 || !dataset2) {
+        fprintf(stderr, "Invalid inputs to pairing_score.\n");
+        return 0;
+    }
+
+    int n = dataset1->row_count;
+    int m = dataset2->row_count;
+    if (!compatibility_scores) {
+        if (!reserve_buffer((void **)&context->scores, &context->scores_capacity, (size_t)n * m, sizeof(int))) {
+            return 0;
+        }
+        compatibility_scores = context->scores;
+    }
+
+    // Start from an empty dictionary, so it holds only the attributes of these inputs
+    clear_attribute_dictionary(&context->dictionary);
+    if (!intern_rows(context, dataset1, &context->rows1) || !intern_rows(context, dataset2, &context->rows2)) {
+        return 0;
+    }
+    if (context->weights && !resolve_weights(context)) return 0;
+
+    int num_workers = thread_pool_size(context->pool);
+    if (analytics) {
+        if (!context->worker_analytics) {
+            context->worker_analytics = calloc(num_workers, sizeof(ScoreAnalytics));
+            if (!context->worker_analytics) {
+                perror("Failed to allocate memory for score analytics");
+                return 0;
+            }
+        }
+        if (!init_score_analytics(analytics, m)) return 0;
+        for (int w = 0; w < num_workers; w++) {
+            if (!init_score_analytics(&context->worker_analytics[w], m)) return 0;
+        }
+    }
+
+    ScoreBatch batch = {.rows1 = &context->rows1,
+                        .rows2 = &context->rows2,
+                        .n = n,
+                        .m = m,
+                        .compatibility_scores = compatibility_scores,
+                        .weights = context->weights ? context->id_weights : NULL,
+                        .worker_analytics = analytics ? context->worker_analytics : NULL,
+                        .cancel = context->cancel};
+    thread_pool_run(context->pool, batch.weights ? score_rows_weighted_task : score_rows_task, &batch,
+                    (n + ROWS_PER_TASK - 1) / ROWS_PER_TASK);
+
+    if (analytics) {
+        for (int w = 0; w < num_workers; w++) {
+            merge_score_analytics(analytics, &context->worker_analytics[w]);
+        }
+        if (!rank_attribute_overlaps(analytics, &context->dictionary, context->rows1.ids, context->rows1.offsets[n],
+                                     context->rows2.ids, context->rows2.offsets[m])) {
+            return 0;
+        }
+    }
+
+    context->last_scores = compatibility_scores;
+    context->last_row_count = n;
+    context->last_column_count = m;
+    return 1;
+} // pairing_score_with_analytics
+
+/**
+ * @brief Returns the matrix filled by the most recent scoring call.
+ *
+ * The view stays valid until the next call on the context (or until the caller's
+ * buffer is released, if one was provided).
+ *
+ * @param context Pointer to the context.
+ * @return Pointer to the row-major score matrix, or NULL if nothing was scored yet.
+ */
+const int *pairing_scores(const PairingContext *context) {
+    return context->last_scores;
+} // pairing_scores
+
+/**
+ * @brief Scores two datasets and assigns each mentee to a mentor within capacity.
+ *
+ * Produces the same assignment as `select_optimal_matches` (or `select_bucketed_matches`
+ * or `select_stable_matches` when another engine is selected) without writing the
+ * arrangement log. The quality of the result is available from `pairing_report` afterwards.
+ *
+ * @param context Pointer to the context.
+ * @param mentees Pointer to the dataset of mentees.
+ * @param mentors Pointer to the dataset of mentors.
+ * @param matches Caller buffer of `n` mentor indices (-1 when unmatched).
+ * @param match_scores Optional caller buffer of `n` scores of the assigned pairs (may be NULL).
+ * @return 1 on success, 0 on failure.
+ */
+int pairing_match(PairingContext *context, const DataSet *mentees, const DataSet *mentors, int *matches, int *match_scores) {
+    if (!matches || !pairing_score(context, mentees, mentors, NULL)) return 0;
+
+    int n = mentees->row_count;
+    int m = mentors->row_count;
+    if (!reserve_buffer((void **)&context->capacity_remaining, &context->capacity_remaining_capacity, m, sizeof(int))) {
+        return 0;
+    }
+    for (int j = 0; j < m; j++) context->capacity_remaining[j] = mentors->rows[j].capacity;
+
+    bool completed = true;
+    if (context->solver == SOLVER_BUCKETED) {
+        if (!assign_by_score_buckets(context->scores, n, m, context->capacity_remaining, matches, &context->buckets,
+                                     context->cancel)) {
+            return 0;
+        }
+        completed = !is_cancelled(context->cancel);
+    } else if (context->solver == SOLVER_STABLE) {
+        if (!assign_stable_matching(context->scores, n, m, context->capacity_remaining, matches, context->pool,
+                                    &context->stable, context->cancel)) {
+            return 0;
+        }
+        completed = !is_cancelled(context->cancel);
+    } else {
+        for (int i = 0; i < n; i++) {
+            if (completed && is_cancelled(context->cancel)) completed = false;
+            matches[i] = completed ? select_best_mentor(context->scores + (size_t)i * m, m, context->capacity_remaining)
+                                   : -1;
+            if (matches[i] != -1) context->capacity_remaining[matches[i]]--;
+        }
+    }
+    if (context->cancel && context->cancel->has_deadline && context->solver != SOLVER_STABLE) {
+        completed = improve_assignment(context->scores, n, m, context->capacity_remaining, matches, context->cancel) &&
+                    completed;
+    }
+    evaluate_assignment(context->scores, n, m, matches, &context->report);
+    context->report.completed = completed;
+
+    if (match_scores) {
+        for (int i = 0; i < n; i++) {
+            match_scores[i] = matches[i] != -1 ? context->scores[(size_t)i * m + matches[i]] : 0;
+        }
+    }
+    return 1;
+} // pairing_match
+
+/**
+ * @brief Returns the quality of the most recent `pairing_match` result.
+ *
+ * @param context Pointer to the context.
+ * @return Pointer to the report, valid until the next call on the context.
+ */
+const SolverReport *pairing_report(const PairingContext *context) {
+    return &context->report;
+} // pairing_report
+
+/**
+ * @brief Writes the results of the most recent call to an output file.
+ *
+ * This is the only library function that performs file I/O.
+ *
+ * @param context Pointer to the context whose last score matrix is written.
+ * @param filename Path to the CSV output file.
+ * @param dataset1 Pointer to the dataset of mentees or participants.
+ * @param dataset2 Pointer to the dataset of mentors or panels.
+ * @param matches Array of mentor indices (unused for `participant_panel`).
+ * @param is_participant_panel Boolean flag to indicate `participant_panel` mode.
+ * @param store_filename Path to an indexed binary result store, or NULL to skip it.
+ * @return 1 on success, 0 on failure.
+ */
+int pairing_write_output(PairingContext *context, const char *filename, DataSet *dataset1, DataSet *dataset2, int *matches, bool is_participant_panel, const char *store_filename) {
+    if (!context->last_scores || context->last_row_count != dataset1->row_count ||
+        context->last_column_count != dataset2->row_count) {
+        fprintf(stderr, "Error: No scores have been computed for these datasets.\n");
+        return 0;
+    }
+    return write_output_file(filename, dataset1, dataset2, matches, context->last_scores,
+                             is_participant_panel, store_filename);
+} // pairing_write_output
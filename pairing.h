@@ -0,0 +1,51 @@
+/**
+ * @file pairing.h
+ * @brief Public interface of the embeddable pairing library (`libpairing`).
+ *
+ * Declares an opaque, reusable matching context that owns a worker thread pool,
+ * an interned attribute dictionary and all scratch buffers. Inputs are in-memory
+ * `DataSet`s and results are returned through caller-provided buffers; no files
+ * are read or written unless `pairing_write_output` is called.
+ *
+ * Dependencies:
+ * - `attribute_weights.h`: Defines the `AttributeWeights` applied while scoring.
+ * - `input_parser.h`: Defines the `DataSet` and `DataRow` structures used for input data.
+ * - `score_analytics.h`: Defines the `ScoreAnalytics` counters filled while scoring.
+ * - `solution_selector.h`: Defines the `SolverKind` assignment engines and `SolverReport`.
+ * - `synchronization.h`: Defines the `CancellationToken` that bounds a call.
+ *
+ * Notes:
+ * - Buffers only grow, so repeated calls with inputs of similar size do not allocate.
+ * - The attribute dictionary is refilled by every scoring call, so a long-lived context
+ *   holds only the attributes of its latest inputs.
+ * - A context must not be used by more than one thread at a time.
+ */
+#ifndef PAIRING_H
+#define PAIRING_H
+
+#include <stdbool.h>
+#include "attribute_weights.h"
+#include "input_parser.h"
+#include "score_analytics.h"
+#include "solution_selector.h"
+#include "synchronization.h"
+
+/**
+ * @brief Opaque handle to a reusable matching context.
+ */
+typedef struct PairingContext PairingContext;
+
+// Function Declarations
+PairingContext *pairing_create(int num_threads);
+void pairing_destroy(PairingContext *context);
+void pairing_set_solver(PairingContext *context, SolverKind solver);
+void pairing_set_cancellation(PairingContext *context, CancellationToken *cancel);
+void pairing_set_weights(PairingContext *context, const AttributeWeights *weights);
+int pairing_score(PairingContext *context, const DataSet *dataset1, const DataSet *dataset2, int *compatibility_scores);
+int pairing_score_with_analytics(PairingContext *context, const DataSet *dataset1, const DataSet *dataset2, int *compatibility_scores, ScoreAnalytics *analytics);
+const int *pairing_scores(const PairingContext *context);
+int pairing_match(PairingContext *context, const DataSet *mentees, const DataSet *mentors, int *matches, int *match_scores);
+const SolverReport *pairing_report(const PairingContext *context);
+int pairing_write_output(PairingContext *context, const char *filename, DataSet *dataset1, DataSet *dataset2, int *matches, bool is_participant_panel, const char *store_filename);
+
+#endif // PAIRING_H
@@ -0,0 +1,348 @@
+/**
+ * @file process_sharding.c
+ * @brief Coordinator that spreads compatibility scoring across worker processes.
+ *
+ * The coordinator creates a POSIX shared-memory score matrix and forks one worker
+ * process per shard. Each worker scores a contiguous range of rows from the first
+ * dataset against the whole second dataset and writes directly into its slice of
+ * the shared matrix. Workers are independent processes, so they can be restarted
+ * or run under separate resource limits; a worker that crashes only causes its own
+ * shard to be rescored. When a cancellation token is given, workers stop at the
+ * next row once it fires and the coordinator kills any worker still running.
+ *
+ * Dependencies:
+ * - `process_sharding.h`: Declares the interface for this functionality.
+ * - `score_matrix.h`: Hands the shared matrix to the caller without copying it.
+ * - `matching_engine.h`: Provides the `calculate_score` and `calculate_weighted_score` functions.
+ */
+#include "process_sharding.h"
+#include "matching_engine.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CANCELLATION_POLL_MS 10 // Longest wait between cancellation checks when the token has a deadline
+
+/**
+ * @brief Describes the range of rows scored by one worker process.
+ */
+typedef struct {
+    int start;     // First row of the shard (inclusive)
+    int end;       // Last row of the shard (exclusive)
+    pid_t pid;     // Worker currently scoring this shard, or -1 when idle
+    int exit_fd;   // Read end of a pipe that reaches end-of-file when the worker exits, or -1
+    int attempts;  // Number of times the shard has been handed to a worker
+} Shard;
+
+/**
+ * @brief Scores one shard of the first dataset into the shared matrix.
+ *
+ * Runs inside the worker process and never returns.
+ *
+ * @param dataset1 Pointer to the first dataset (e.g., mentees or participants).
+ * @param dataset2 Pointer to the second dataset (e.g., mentors or panels).
+ * @param shared_scores Pointer to the shared-memory score matrix.
+ * @param shard Pointer to the shard to be scored.
+ * @param weights Attribute weights, or NULL to count shared attributes.
+ * @param cancel Token checked before each row (may be NULL).
+ */
+static void run_shard_worker(DataSet *dataset1, DataSet *dataset2, int *shared_scores, const Shard *shard, const AttributeWeights *weights, CancellationToken *cancel) {
+    int m = dataset2->row_count;
+    for (int i = shard->start; i < shard->end; i++) {
+        if (is_cancelled(cancel)) break;
+        int *out = shared_scores + (size_t)i * m;
+        if (weights) {
+            for (int j = 0; j < m; j++) out[j] = calculate_weighted_score(&dataset1->rows[i], &dataset2->rows[j], weights);
+        } else {
+            for (int j = 0; j < m; j++) out[j] = calculate_score(&dataset1->rows[i], &dataset2->rows[j]);
+        }
+    }
+    _exit(EXIT_SUCCESS); // Skip atexit handlers inherited from the coordinator
+} // run_shard_worker
+
+/**
+ * @brief Forks a worker process for a shard.
+ *
+ * The worker holds the only write end of a pipe, which the kernel closes when the
+ * worker exits for any reason, so the coordinator can sleep until one of its own
+ * workers is done.
+ *
+ * @return 1 if the worker was started, 0 on failure.
+ */
+static int launch_shard(DataSet *dataset1, DataSet *dataset2, int *shared_scores, Shard *shard, const AttributeWeights *weights, CancellationToken *cancel) {
+    int exit_pipe[2];
+    if (pipe(exit_pipe) != 0) {
+        perror("Failed to create shard worker pipe");
+        return 0;
+    }
+
+    fflush(NULL); // Avoid duplicating buffered output in the child
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("Failed to fork shard worker");
+        close(exit_pipe[0]);
+        close(exit_pipe[1]);
+        return 0;
+    }
+    if (pid == 0) {
+        close(exit_pipe[0]);
+        run_shard_worker(dataset1, dataset2, shared_scores, shard, weights, cancel);
+    }
+    close(exit_pipe[1]);
+    shard->pid = pid;
+    shard->exit_fd = exit_pipe[0];
+    shard->attempts++;
+    return 1;
+} // launch_shard
+
+/**
+ * @brief Reaps the worker of a shard that has exited and marks the shard idle.
+ *
+ * @return The result of `waitpid`.
+ */
+static pid_t reap_shard(Shard *shard, int *status) {
+    pid_t pid;
+    do {
+        pid = waitpid(shard->pid, status, 0);
+    } while (pid < 0 && errno == EINTR);
+    close(shard->exit_fd);
+    shard->exit_fd = -1;
+    shard->pid = -1;
+    return pid;
+} // reap_shard
+
+/**
+ * @brief Kills and reaps every worker that is still running.
+ */
+static void stop_shards(Shard *shards, int num_shards) {
+    for (int s = 0; s < num_shards; s++) {
+        if (shards[s].pid == -1) continue;
+        kill(shards[s].pid, SIGKILL);
+        reap_shard(&shards[s], NULL);
+    }
+} // stop_shards
+
+/**
+ * @brief Waits for any worker to exit, stopping every worker once `cancel` fires.
+ *
+ * The coordinator sleeps in `poll` on the workers' exit pipes, so it uses no CPU
+ * while they score. Only this call's workers are waited for, so the exit statuses
+ * of other children of the process (for example those of an application embedding
+ * the library) are left alone. With a deadline, the wait is cut into intervals of
+ * `CANCELLATION_POLL_MS` so that the deadline, or a cancellation requested from
+ * another thread, is noticed; without one, the token is checked whenever a worker
+ * exits or a signal interrupts the wait.
+ *
+ * @param shards Shards of the call.
+ * @param num_shards Number of shards.
+ * @param status Receives the wait status of the exited worker.
+ * @param cancel Token that stops the workers (may be NULL).
+ * @return Index of the shard whose worker exited and was reaped, -1 if the workers
+ *         were stopped, or -2 on error.
+ */
+static int wait_for_shard(Shard *shards, int num_shards, int *status, CancellationToken *cancel) {
+    struct pollfd *descriptors = malloc(num_shards * sizeof(struct pollfd));
+    int *owners = malloc(num_shards * sizeof(int));
+    if (!descriptors || !owners) {
+        perror("Failed to allocate memory for shard wait");
+        free(descriptors);
+        free(owners);
+        return -2;
+    }
+
+    int exited = -1;
+    while (exited == -1 && !is_cancelled(cancel)) {
+        int count = 0;
+        for (int s = 0; s < num_shards; s++) {
+            if (shards[s].pid == -1) continue;
+            descriptors[count] = (struct pollfd){.fd = shards[s].exit_fd, .events = POLLIN};
+            owners[count++] = s;
+        }
+        int ready = poll(descriptors, count, cancel && cancel->has_deadline ? CANCELLATION_POLL_MS : -1);
+        if (ready < 0 && errno != EINTR) {
+            perror("Failed to wait for shard worker");
+            exited = -2;
+            break;
+        }
+        for (int k = 0; ready > 0 && k < count; k++) {
+            if (descriptors[k].revents == 0) continue;
+            exited = owners[k];
+            if (reap_shard(&shards[exited], status) < 0) {
+                perror("Failed to reap shard worker");
+                exited = -2;
+            }
+            break;
+        }
+    }
+    free(descriptors);
+    free(owners);
+
+    if (exited == -1) stop_shards(shards, num_shards);
+    return exited;
+} // wait_for_shard
+
+/**
+ * @brief `ScoreStorageRelease` for the shared-memory mapping.
+ */
+static void unmap_shared_scores(int *scores, size_t size) {
+    munmap(scores, size > 0 ? size : 1);
+} // unmap_shared_scores
+
+/**
+ * @brief Computes compatibility scores into a shared matrix using worker processes.
+ *
+ * Splits the rows of the first dataset into `num_workers` contiguous shards and forks
+ * one worker per shard. The workers write into a POSIX shared-memory matrix, which is
+ * returned as the result once every shard has completed, without copying it. Shards
+ * whose worker exits abnormally are rescored, up to `MAX_SHARD_RETRIES` times.
+ *
+ * If `cancel` fires before every shard is done, the workers are stopped and the pairs
+ * they had not scored yet are left at 0; the call still succeeds.
+ *
+ * @param dataset1 Pointer to the first dataset (e.g., mentees or participants).
+ * @param dataset2 Pointer to the second dataset (e.g., mentors or panels).
+ * @param num_workers Number of worker processes to fork.
+ * @param weights Attribute weights, or NULL to count shared attributes.
+ * @param cancel Token that stops scoring early (may be NULL).
+ * @return The score matrix, or NULL on failure. The caller owns it, and `score_matrix_free` unmaps its storage.
+ */
+ScoreMatrix *match_datasets_sharded_matrix(DataSet *dataset1, DataSet *dataset2, int num_workers, const AttributeWeights *weights, CancellationToken *cancel) {
+    if (!dataset1 || !dataset2 || num_workers < 1) {
+        fprintf(stderr, "Invalid inputs to match_datasets_sharded.\n");
+        return NULL;
+    }
+
+    int n = dataset1->row_count;
+    int m = dataset2->row_count;
+    size_t matrix_size = (size_t)n * m * sizeof(int);
+
+    // Step 1: Create the shared-memory score matrix
+    char shm_name[64];
+    snprintf(shm_name, sizeof(shm_name), "/pairing_scores_%ld", (long)getpid());
+    int fd = shm_open(shm_name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        perror("Failed to create shared score matrix");
+        return NULL;
+    }
+    shm_unlink(shm_name); // The mapping stays valid; the name is no longer needed
+
+    size_t mapped_size = matrix_size > 0 ? matrix_size : 1;
+    if (ftruncate(fd, (off_t)mapped_size) != 0) {
+        perror("Failed to size shared score matrix");
+        close(fd);
+        return NULL;
+    }
+
+    int *shared_scores = mmap(NULL, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shared_scores == MAP_FAILED) {
+        perror("Failed to map shared score matrix");
+        return NULL;
+    }
+    ScoreMatrix *matrix = score_matrix_wrap(shared_scores, n, m, unmap_shared_scores);
+    if (!matrix || matrix_size == 0) return matrix;
+
+    // Step 2: Split the first dataset into shards and launch the workers
+    if (num_workers > n) num_workers = n;
+    Shard *shards = malloc(num_workers * sizeof(Shard));
+    if (!shards) {
+        perror("Failed to allocate memory for shards");
+        score_matrix_free(matrix);
+        return NULL;
+    }
+
+    int running = 0;
+    int failed = 0;
+    for (int s = 0; s < num_workers; s++) {
+        shards[s] = (Shard){.start = (int)((long)n * s / num_workers),
+                            .end = (int)((long)n * (s + 1) / num_workers),
+                            .pid = -1,
+                            .exit_fd = -1,
+                            .attempts = 0};
+        if (launch_shard(dataset1, dataset2, shared_scores, &shards[s], weights, cancel)) {
+            running++;
+        } else {
+            failed = 1;
+        }
+    }
+
+    // Step 3: Reap workers, rescoring only the shards whose worker failed
+    while (running > 0) {
+        int status;
+        int s = wait_for_shard(shards, num_workers, &status, cancel);
+        if (s == -1) break; // Cancelled; unscored pairs keep their zero fill
+        if (s < 0) {
+            failed = 1;
+            break;
+        }
+
+        running--;
+        if (WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS) continue;
+
+        fprintf(stderr, "Shard worker for rows %d-%d failed (attempt %d).\n",
+                shards[s].start, shards[s].end - 1, shards[s].attempts);
+        if (shards[s].attempts <= MAX_SHARD_RETRIES &&
+            launch_shard(dataset1, dataset2, shared_scores, &shards[s], weights, cancel)) {
+            running++;
+        } else {
+            failed = 1;
+        }
+    }
+
+    // After an error, no worker may outlive the mapping or be left for the embedding process to reap
+    stop_shards(shards, num_workers);
+    free(shards);
+
+    if (failed) {
+        fprintf(stderr, "Sharded scoring failed.\n");
+        score_matrix_free(matrix);
+        return NULL;
+    }
+    return matrix;
+} // match_datasets_sharded_matrix
+
+/**
+ * @brief Computes compatibility scores using a pool of worker processes.
+ *
+ * Convenience form of `match_datasets_sharded_matrix` that returns the scores in a
+ * private array.
+ *
+ * @param dataset1 Pointer to the first dataset (e.g., mentees or participants).
+ * @param dataset2 Pointer to the second dataset (e.g., mentors or panels).
+ * @param compatibility_scores Pointer to an array to store compatibility scores.
+ *                             The array is dynamically allocated and must be freed by the caller.
+ * @param num_workers Number of worker processes to fork.
+ * @param weights Attribute weights, or NULL to count shared attributes.
+ * @param cancel Token that stops scoring early (may be NULL).
+ * @return 1 on success, 0 on failure.
+ */
+int match_datasets_sharded(DataSet *dataset1, DataSet *dataset2, int **compatibility_scores, int num_workers, const AttributeWeights *weights, CancellationToken *cancel) {
+    if (!compatibility_scores) {
+        fprintf(stderr, "Invalid inputs to match_datasets_sharded.\n");
+        return 0;
+    }
+    *compatibility_scores = NULL;
+
+    ScoreMatrix *matrix = match_datasets_sharded_matrix(dataset1, dataset2, num_workers, weights, cancel);
+    if (!matrix) return 0;
+
+    size_t matrix_size = (size_t)matrix->rows * matrix->columns * sizeof(int);
+    *compatibility_scores = malloc(matrix_size > 0 ? matrix_size : 1);
+    if (!*compatibility_scores) {
+        perror("Failed to allocate memory for compatibility scores");
+        score_matrix_free(matrix);
+        return 0;
+    }
+    memcpy(*compatibility_scores, matrix->scores, matrix_size);
+    score_matrix_free(matrix);
+    return 1;
+} // match_datasets_sharded
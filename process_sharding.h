@@ -0,0 +1,32 @@
+/**
+ * @file process_sharding.h
+ * @brief Header file for the multi-process sharded scoring coordinator.
+ *
+ * Declares the coordinator that forks worker processes, each of which scores a
+ * contiguous shard of the first dataset into a POSIX shared-memory score matrix.
+ *
+ * Dependencies:
+ * - `attribute_weights.h`: Defines the `AttributeWeights` applied while scoring.
+ * - `input_parser.h`: Defines the `DataSet` and `DataRow` structures used for data representation.
+ * - `score_matrix.h`: Defines the `ScoreMatrix` that wraps the shared result.
+ * - `synchronization.h`: Defines the `CancellationToken` that can stop scoring early.
+ *
+ * Notes:
+ * - Without weights, the resulting matrix is identical to the one produced by `match_datasets`.
+ * - A worker that crashes only causes its own shard to be rescored.
+ */
+#ifndef PROCESS_SHARDING_H
+#define PROCESS_SHARDING_H
+
+#include "attribute_weights.h"
+#include "input_parser.h"
+#include "score_matrix.h"
+#include "synchronization.h"
+
+#define MAX_SHARD_RETRIES 3 // Maximum number of times a failed shard is rescored
+
+// Function Declarations
+ScoreMatrix *match_datasets_sharded_matrix(DataSet *dataset1, DataSet *dataset2, int num_workers, const AttributeWeights *weights, CancellationToken *cancel);
+int match_datasets_sharded(DataSet *dataset1, DataSet *dataset2, int **compatibility_scores, int num_workers, const AttributeWeights *weights, CancellationToken *cancel);
+
+#endif // PROCESS_SHARDING_H
@@ -0,0 +1,53 @@
+/**
+ * @file result_lookup.c
+ * @brief Command-line tool for point queries against a binary result store.
+ *
+ * Prints the matches of each requested mentee or participant in the same
+ * format as `output.csv`, without loading or scanning the whole store.
+ *
+ * Dependencies:
+ * - `result_store.h`: Provides the result store lookup API.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "result_store.h"
+
+/**
+ * @brief Displays usage instructions
+ *
+ * @param program_name
+ */
+void print_usage(const char *program_name) {
+    printf("Usage: %s <result_store> <name> [name...]\n", program_name);
+} // print_usage
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    ResultStore *store = open_result_store(argv[1]);
+    if (!store) return EXIT_FAILURE;
+
+    int status = EXIT_SUCCESS;
+    for (int i = 2; i < argc; i++) {
+        ResultEntry entry;
+        if (!result_store_lookup(store, argv[i], &entry)) {
+            fprintf(stderr, "Error: %s not found in %s\n", argv[i], argv[1]);
+            status = EXIT_FAILURE;
+            continue;
+        }
+
+        if (entry.match_count == 0 && !result_store_is_participant_panel(store)) {
+            printf("%s,No Match,0\n", entry.name);
+        }
+        for (int k = 0; k < entry.match_count; k++) {
+            const char *target = result_store_target_name(store, entry.match_indices[k]);
+            printf("%s,%s,%d\n", entry.name, target ? target : "(none)", entry.scores[k]);
+        }
+    }
+
+    close_result_store(store);
+    return status;
+} // main
@@ -0,0 +1,420 @@
+/**
+ * @file result_store.c
+ * @brief Memory-mappable binary result file with a name-to-row hash index.
+ *
+ * The file consists of a fixed header followed by 8-byte aligned sections:
+ * - name offsets for every row of both datasets (into the string pool),
+ * - per-row match offsets, match indices and match scores (CSR layout),
+ * - an open-addressing hash index from first-dataset names to rows,
+ * - a string pool of NUL-terminated names.
+ *
+ * Readers map the file and resolve a name with a single hash probe sequence,
+ * so point queries are O(1) and never load the rest of the file. Writers replace
+ * the file with a rename, so a reader's mapping is never truncated under it.
+ *
+ * Dependencies:
+ * - `result_store.h`: Declares the interface for this functionality.
+ */
+#include "result_store.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define RESULT_STORE_MAGIC "PAIRIDX1" // File signature (8 bytes)
+#define RESULT_STORE_VERSION 1        // Bumped whenever the layout changes
+#define EMPTY_BUCKET -1               // Marks an unused hash index bucket
+
+/**
+ * @brief Fixed-size header at the start of the file.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t is_participant_panel;
+    uint32_t row_count;           // Rows in the first dataset
+    uint32_t target_count;        // Rows in the second dataset
+    uint32_t match_count;         // Total number of recorded matches
+    uint32_t bucket_count;        // Hash index size (power of two)
+    uint64_t row_names_offset;    // uint32_t[row_count]
+    uint64_t target_names_offset; // uint32_t[target_count]
+    uint64_t match_offsets_offset; // uint32_t[row_count + 1]
+    uint64_t match_indices_offset; // int32_t[match_count]
+    uint64_t match_scores_offset; // int32_t[match_count]
+    uint64_t buckets_offset;      // int32_t[bucket_count]
+    uint64_t strings_offset;      // char[strings_size]
+    uint64_t strings_size;
+} ResultStoreHeader;
+
+struct ResultStore {
+    void *base;                   // Start of the mapping
+    size_t size;                  // Size of the mapping
+    const ResultStoreHeader *header;
+    const uint32_t *row_names;
+    const uint32_t *target_names;
+    const uint32_t *match_offsets;
+    const int32_t *match_indices;
+    const int32_t *match_scores;
+    const int32_t *buckets;
+    const char *strings;
+};
+
+/**
+ * @brief FNV-1a hash of a NUL-terminated name.
+ */
+static uint32_t hash_name(const char *name) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash;
+} // hash_name
+
+/**
+ * @brief Rounds a section size up to the 8-byte alignment used for every section.
+ */
+static uint64_t align8(uint64_t size) {
+    return (size + 7) & ~(uint64_t)7;
+} // align8
+
+/**
+ * @brief Writes a section followed by zero padding up to the next 8-byte boundary.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+static int write_section(FILE *file, const void *data, uint64_t size) {
+    static const char padding[8] = {0};
+    if (size > 0 && fwrite(data, 1, size, file) != size) return 0;
+    uint64_t pad = align8(size) - size;
+    return pad == 0 || fwrite(padding, 1, pad, file) == pad;
+} // write_section
+
+/**
+ * @brief Appends the names of a dataset to the string pool and records their offsets.
+ *
+ * @return The new size of the string pool.
+ */
+static uint64_t pool_names(DataSet *dataset, uint32_t *offsets, char *pool, uint64_t used) {
+    for (int i = 0; i < dataset->row_count; i++) {
+        const char *name = dataset->rows[i].name ? dataset->rows[i].name : "";
+        size_t len = strlen(name) + 1;
+        offsets[i] = (uint32_t)used;
+        if (pool) memcpy(pool + used, name, len);
+        used += len;
+    }
+    return used;
+} // pool_names
+
+/**
+ * @brief Writes the matching results to an indexed binary result store.
+ *
+ * Records the same matches as `write_output_file`: the assigned mentor of every
+ * mentee, or every panel with a positive score for each participant.
+ *
+ * @param filename Path to the result store to be written.
+ * @param dataset1 Pointer to the dataset of mentees or participants.
+ * @param dataset2 Pointer to the dataset of mentors or panels.
+ * @param matches Array of assigned mentor indices (unused for `participant_panel`).
+ * @param compatibility_scores Compatibility scores array for all pairings.
+ * @param is_participant_panel Boolean flag to indicate `participant_panel` mode.
+ * @return 1 on success, 0 on failure.
+ */
+int write_result_store(const char *filename, DataSet *dataset1, DataSet *dataset2, int *matches, const int *compatibility_scores, bool is_participant_panel) {
+    int n = dataset1->row_count;
+    int m = dataset2->row_count;
+
+    // Step 1: Collect the matches of every row in CSR form
+    uint32_t *match_offsets = malloc((n + 1) * sizeof(uint32_t));
+    uint32_t match_count = 0;
+    if (!match_offsets) {
+        perror("Failed to allocate memory for result store");
+        return 0;
+    }
+    for (int i = 0; i < n; i++) {
+        match_offsets[i] = match_count;
+        if (is_participant_panel) {
+            for (int j = 0; j < m; j++) {
+                if (compatibility_scores[(size_t)i * m + j] > 0) match_count++;
+            }
+        } else if (matches[i] >= 0 && matches[i] < m) {
+            match_count++;
+        }
+    }
+    match_offsets[n] = match_count;
+
+    // Step 2: Build the string pool and the hash index
+    uint32_t bucket_count = 1;
+    while (bucket_count < 2 * (uint32_t)n) bucket_count <<= 1;
+
+    uint32_t *row_names = malloc((n > 0 ? n : 1) * sizeof(uint32_t));
+    uint32_t *target_names = malloc((m > 0 ? m : 1) * sizeof(uint32_t));
+    int32_t *match_indices = malloc((match_count > 0 ? match_count : 1) * sizeof(int32_t));
+    int32_t *match_scores = malloc((match_count > 0 ? match_count : 1) * sizeof(int32_t));
+    int32_t *buckets = malloc(bucket_count * sizeof(int32_t));
+    uint64_t strings_size = pool_names(dataset2, target_names, NULL, pool_names(dataset1, row_names, NULL, 0));
+    char *strings = malloc(strings_size > 0 ? strings_size : 1);
+    if (!row_names || !target_names || !match_indices || !match_scores || !buckets || !strings) {
+        perror("Failed to allocate memory for result store");
+        free(match_offsets);
+        free(row_names);
+        free(target_names);
+        free(match_indices);
+        free(match_scores);
+        free(buckets);
+        free(strings);
+        return 0;
+    }
+    pool_names(dataset2, target_names, strings, pool_names(dataset1, row_names, strings, 0));
+
+    for (int i = 0; i < n; i++) {
+        uint32_t k = match_offsets[i];
+        if (is_participant_panel) {
+            for (int j = 0; j < m; j++) {
+                int score = compatibility_scores[(size_t)i * m + j];
+                if (score > 0) {
+                    match_indices[k] = j;
+                    match_scores[k++] = score;
+                }
+            }
+        } else if (matches[i] >= 0 && matches[i] < m) {
+            match_indices[k] = matches[i];
+            match_scores[k] = compatibility_scores[(size_t)i * m + matches[i]];
+        }
+    }
+
+    // Rows are inserted in order, so a lookup of a repeated name finds its first row
+    int duplicates = 0;
+    for (uint32_t b = 0; b < bucket_count; b++) buckets[b] = EMPTY_BUCKET;
+    for (int i = 0; i < n; i++) {
+        const char *name = strings + row_names[i];
+        uint32_t b = hash_name(name) & (bucket_count - 1);
+        bool duplicate = false;
+        for (; buckets[b] != EMPTY_BUCKET; b = (b + 1) & (bucket_count - 1)) {
+            if (!duplicate && strcmp(strings + row_names[buckets[b]], name) == 0) duplicate = true;
+        }
+        buckets[b] = i;
+        duplicates += duplicate;
+    }
+    if (duplicates > 0) {
+        fprintf(stderr, "Warning: %d rows of %s repeat an earlier name; lookups of those names return the first row.\n",
+                duplicates, filename);
+    }
+
+    // Step 3: Lay out the sections and write the file
+    ResultStoreHeader header = {0};
+    memcpy(header.magic, RESULT_STORE_MAGIC, sizeof(header.magic));
+    header.version = RESULT_STORE_VERSION;
+    header.is_participant_panel = is_participant_panel;
+    header.row_count = n;
+    header.target_count = m;
+    header.match_count = match_count;
+    header.bucket_count = bucket_count;
+    header.row_names_offset = align8(sizeof(header));
+    header.target_names_offset = header.row_names_offset + align8((uint64_t)n * sizeof(uint32_t));
+    header.match_offsets_offset = header.target_names_offset + align8((uint64_t)m * sizeof(uint32_t));
+    header.match_indices_offset = header.match_offsets_offset + align8((uint64_t)(n + 1) * sizeof(uint32_t));
+    header.match_scores_offset = header.match_indices_offset + align8((uint64_t)match_count * sizeof(int32_t));
+    header.buckets_offset = header.match_scores_offset + align8((uint64_t)match_count * sizeof(int32_t));
+    header.strings_offset = header.buckets_offset + align8((uint64_t)bucket_count * sizeof(int32_t));
+    header.strings_size = strings_size;
+
+    // Write to a temporary file and rename it into place, so readers that have the
+    // old file mapped keep their pages and never see a partially written store
+    char tmp_path[PATH_MAX];
+    int ok = 0;
+    FILE *file = NULL;
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", filename) >= (int)sizeof(tmp_path)) {
+        fprintf(stderr, "Error: Result store path is too long: %s\n", filename);
+    } else if (!(file = fopen(tmp_path, "wb"))) {
+        perror("Failed to open result store file");
+    } else {
+        ok = write_section(file, &header, sizeof(header)) &&
+             write_section(file, row_names, (uint64_t)n * sizeof(uint32_t)) &&
+             write_section(file, target_names, (uint64_t)m * sizeof(uint32_t)) &&
+             write_section(file, match_offsets, (uint64_t)(n + 1) * sizeof(uint32_t)) &&
+             write_section(file, match_indices, (uint64_t)match_count * sizeof(int32_t)) &&
+             write_section(file, match_scores, (uint64_t)match_count * sizeof(int32_t)) &&
+             write_section(file, buckets, (uint64_t)bucket_count * sizeof(int32_t)) &&
+             write_section(file, strings, strings_size) &&
+             fflush(file) == 0 && fsync(fileno(file)) == 0;
+        if (fclose(file) != 0) ok = 0;
+        if (!ok || rename(tmp_path, filename) != 0) {
+            perror("Failed to write result store");
+            remove(tmp_path);
+            ok = 0;
+        }
+    }
+
+    free(match_offsets);
+    free(row_names);
+    free(target_names);
+    free(match_indices);
+    free(match_scores);
+    free(buckets);
+    free(strings);
+    return ok;
+} // write_result_store
+
+/**
+ * @brief Checks that a section is aligned and lies within the file after the header.
+ */
+static bool section_fits(uint64_t offset, uint64_t count, uint64_t element_size, uint64_t file_size) {
+    return offset % 8 == 0 && offset >= sizeof(ResultStoreHeader) && offset <= file_size &&
+           count <= (file_size - offset) / element_size;
+} // section_fits
+
+/**
+ * @brief Validates the header of a mapped result store against the size of the file.
+ *
+ * Every section must lie within the file, the hash index must have a free bucket
+ * so probes terminate, and the string pool must end with a NUL terminator.
+ *
+ * @return true if the header describes a store that fits in `file_size` bytes.
+ */
+static bool header_is_valid(const ResultStoreHeader *header, uint64_t file_size) {
+    const char *bytes = (const char *)header;
+    uint32_t buckets = header->bucket_count;
+    return memcmp(header->magic, RESULT_STORE_MAGIC, sizeof(header->magic)) == 0 &&
+           header->version == RESULT_STORE_VERSION &&
+           buckets > header->row_count && (buckets & (buckets - 1)) == 0 &&
+           section_fits(header->row_names_offset, header->row_count, sizeof(uint32_t), file_size) &&
+           section_fits(header->target_names_offset, header->target_count, sizeof(uint32_t), file_size) &&
+           section_fits(header->match_offsets_offset, (uint64_t)header->row_count + 1, sizeof(uint32_t), file_size) &&
+           section_fits(header->match_indices_offset, header->match_count, sizeof(int32_t), file_size) &&
+           section_fits(header->match_scores_offset, header->match_count, sizeof(int32_t), file_size) &&
+           section_fits(header->buckets_offset, buckets, sizeof(int32_t), file_size) &&
+           section_fits(header->strings_offset, header->strings_size, 1, file_size) &&
+           header->strings_size > 0 && bytes[header->strings_offset + header->strings_size - 1] == '\0';
+} // header_is_valid
+
+/**
+ * @brief Maps a result store for point queries.
+ *
+ * The header and the bounds of every section are validated against the file size;
+ * the pages themselves are faulted in on demand, and lookups check each index they
+ * follow, so a damaged store never reads outside the mapping.
+ *
+ * @param filename Path to the result store.
+ * @return Pointer to the opened store, or NULL on failure.
+ */
+ResultStore *open_result_store(const char *filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        perror("Failed to open result store");
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ResultStoreHeader)) {
+        fprintf(stderr, "Error: %s is not a valid result store.\n", filename);
+        close(fd);
+        return NULL;
+    }
+
+    void *base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        perror("Failed to map result store");
+        return NULL;
+    }
+
+    const ResultStoreHeader *header = base;
+    if (!header_is_valid(header, st.st_size)) {
+        fprintf(stderr, "Error: %s is not a valid result store.\n", filename);
+        munmap(base, st.st_size);
+        return NULL;
+    }
+
+    ResultStore *store = malloc(sizeof(ResultStore));
+    if (!store) {
+        perror("Error allocating memory for result store");
+        munmap(base, st.st_size);
+        return NULL;
+    }
+
+    const char *bytes = base;
+    *store = (ResultStore){.base = base,
+                           .size = st.st_size,
+                           .header = header,
+                           .row_names = (const uint32_t *)(bytes + header->row_names_offset),
+                           .target_names = (const uint32_t *)(bytes + header->target_names_offset),
+                           .match_offsets = (const uint32_t *)(bytes + header->match_offsets_offset),
+                           .match_indices = (const int32_t *)(bytes + header->match_indices_offset),
+                           .match_scores = (const int32_t *)(bytes + header->match_scores_offset),
+                           .buckets = (const int32_t *)(bytes + header->buckets_offset),
+                           .strings = bytes + header->strings_offset};
+    return store;
+} // open_result_store
+
+/**
+ * @brief Looks up the matches of a mentee or participant by name.
+ *
+ * Names are not required to be unique; when several rows share a name, the
+ * entry of the first of them is returned.
+ *
+ * @param store Pointer to an opened result store.
+ * @param name Name of the mentee or participant.
+ * @param entry Pointer to the entry to be filled in.
+ * @return true if the name was found, false otherwise.
+ */
+bool result_store_lookup(const ResultStore *store, const char *name, ResultEntry *entry) {
+    const ResultStoreHeader *header = store->header;
+    uint32_t mask = header->bucket_count - 1;
+    uint32_t b = hash_name(name) & mask;
+
+    int32_t row;
+    for (uint32_t probe = 0; probe < header->bucket_count && (row = store->buckets[b]) != EMPTY_BUCKET;
+         probe++, b = (b + 1) & mask) {
+        if (row < 0 || (uint32_t)row >= header->row_count || store->row_names[row] >= header->strings_size) return false;
+        const char *row_name = store->strings + store->row_names[row];
+        if (strcmp(row_name, name) != 0) continue;
+
+        uint32_t first = store->match_offsets[row];
+        if (first > store->match_offsets[row + 1] || store->match_offsets[row + 1] > header->match_count) return false;
+        *entry = (ResultEntry){.row = row,
+                               .name = row_name,
+                               .match_count = (int)(store->match_offsets[row + 1] - first),
+                               .match_indices = store->match_indices + first,
+                               .scores = store->match_scores + first};
+        return true;
+    }
+    return false;
+} // result_store_lookup
+
+/**
+ * @brief Returns the name of a mentor or panel recorded in the store.
+ *
+ * @param store Pointer to an opened result store.
+ * @param index Row of the mentor or panel in the second dataset.
+ * @return The name, or NULL if the index is out of range.
+ */
+const char *result_store_target_name(const ResultStore *store, int index) {
+    if (index < 0 || (uint32_t)index >= store->header->target_count ||
+        store->target_names[index] >= store->header->strings_size) {
+        return NULL;
+    }
+    return store->strings + store->target_names[index];
+} // result_store_target_name
+
+/**
+ * @brief Reports whether the store holds `participant_panel` results.
+ */
+bool result_store_is_participant_panel(const ResultStore *store) {
+    return store->header->is_participant_panel != 0;
+} // result_store_is_participant_panel
+
+/**
+ * @brief Unmaps a result store and frees its handle.
+ *
+ * @param store Pointer to the store to be closed.
+ */
+void close_result_store(ResultStore *store) {
+    if (!store) return;
+    munmap(store->base, store->size);
+    free(store);
+} // close_result_store
@@ -0,0 +1,51 @@
+/**
+ * @file result_store.h
+ * @brief Header file for the indexed binary result store.
+ *
+ * Declares the functions used to write the matching results to a memory-mappable
+ * binary file and to answer per-person point queries against it without loading
+ * or scanning the whole file.
+ *
+ * Dependencies:
+ * - `input_parser.h`: Provides definitions for the `DataSet` structure.
+ *
+ * Notes:
+ * - Lookups hash the name into an open-addressing index stored in the file, so each
+ *   query touches a constant number of pages of the mapping.
+ * - Names need not be unique, but only the first row with a given name can be looked up.
+ * - Result stores use the native byte order and are not meant to be moved between machines.
+ */
+#ifndef RESULT_STORE_H
+#define RESULT_STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "input_parser.h"
+
+/**
+ * @brief Read-only view of a mapped result store.
+ */
+typedef struct ResultStore ResultStore;
+
+/**
+ * @brief Matches recorded for one mentee or participant.
+ *
+ * Pointers refer to the mapped file and stay valid until the store is closed.
+ */
+typedef struct {
+    int row;                  ///< Row of the person in the first dataset
+    const char *name;         ///< Name of the person
+    int match_count;          ///< Number of matches (0 when unmatched)
+    const int *match_indices; ///< Rows of the matched mentors/panels in the second dataset
+    const int *scores;        ///< Compatibility score of each match
+} ResultEntry;
+
+// Function Declarations
+int write_result_store(const char *filename, DataSet *dataset1, DataSet *dataset2, int *matches, const int *compatibility_scores, bool is_participant_panel);
+ResultStore *open_result_store(const char *filename);
+bool result_store_lookup(const ResultStore *store, const char *name, ResultEntry *entry);
+const char *result_store_target_name(const ResultStore *store, int index);
+bool result_store_is_participant_panel(const ResultStore *store);
+void close_result_store(ResultStore *store);
+
+#endif // RESULT_STORE_H
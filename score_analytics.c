@@ -0,0 +1,397 @@
+/**
+ * @file score_analytics.c
+ * @brief Accumulation, merging and reporting of score analytics.
+ *
+ * Histograms and popularity counts are filled by `record_score` from inside the
+ * scoring kernel. The attribute overlap ranking needs no pass over the matrix at
+ * all: an attribute that occurs `a` times in the first dataset and `b` times in the
+ * second contributes exactly `a * b` to the sum of all scores. Histogram bins are
+ * sized by the highest score seen rather than by a fixed range.
+ *
+ * Dependencies:
+ * - `score_analytics.h`: Declares the interface for this functionality.
+ * - `attribute_dictionary.h`: Names the interned attributes of the overlap ranking.
+ */
+#include "score_analytics.h"
+#include "attribute_dictionary.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Grows a histogram buffer so it can hold at least `count` counts.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+static int reserve_histograms(ScoreAnalytics *analytics, size_t count) {
+    if (count <= analytics->histogram_capacity) return 1;
+
+    size_t capacity = analytics->histogram_capacity ? analytics->histogram_capacity : 64;
+    while (capacity < count) capacity *= 2;
+    long *grown = realloc(analytics->column_histograms, capacity * sizeof(long));
+    if (!grown) {
+        perror("Failed to allocate memory for score analytics");
+        return 0;
+    }
+    analytics->column_histograms = grown;
+    analytics->histogram_capacity = capacity;
+    return 1;
+} // reserve_histograms
+
+/**
+ * @brief Prepares the counters for a matrix with `column_count` columns.
+ *
+ * Buffers are reused when they are large enough; every counter is reset to zero
+ * and the histograms start with a single bin for the score 0.
+ *
+ * @param analytics Pointer to the analytics structure.
+ * @param column_count Number of columns (mentors or panels).
+ * @return 1 on success, 0 on failure.
+ */
+int init_score_analytics(ScoreAnalytics *analytics, int column_count) {
+    if (column_count > analytics->column_capacity) {
+        long *match_counts = realloc(analytics->match_counts, column_count * sizeof(long));
+        if (!match_counts) {
+            perror("Failed to allocate memory for score analytics");
+            return 0;
+        }
+        analytics->match_counts = match_counts;
+        analytics->column_capacity = column_count;
+    }
+    if (!reserve_histograms(analytics, column_count)) return 0;
+
+    analytics->column_count = column_count;
+    analytics->bin_count = 1;
+    analytics->bin_shift = 0;
+    memset(analytics->match_counts, 0, column_count * sizeof(long));
+    memset(analytics->column_histograms, 0, column_count * sizeof(long));
+    for (int k = 0; k < analytics->top_overlap_count; k++) {
+        free(analytics->top_overlaps[k].attribute);
+    }
+    analytics->top_overlap_count = 0;
+    return 1;
+} // init_score_analytics
+
+/**
+ * @brief Makes room in the histograms for `score` with bins at least `1 << bin_shift` wide.
+ *
+ * Bins are added until the last one covers `score`. Once that would exceed
+ * `SCORE_HISTOGRAM_MAX_BINS`, neighbouring bins are added together, which doubles
+ * their width, so the bins always span 0 to the highest score seen.
+ *
+ * @param analytics Pointer to initialized analytics.
+ * @param score Score that must fall into a bin.
+ * @param bin_shift Smallest acceptable bin width, as a power of two.
+ * @return 1 on success, 0 if the bins could not grow (they are left consistent).
+ */
+int widen_score_histograms(ScoreAnalytics *analytics, int score, int bin_shift) {
+    if (bin_shift < analytics->bin_shift) bin_shift = analytics->bin_shift;
+    while ((score >> bin_shift) >= SCORE_HISTOGRAM_MAX_BINS) bin_shift++;
+
+    size_t m = analytics->column_count;
+    long *histograms = analytics->column_histograms;
+    while (analytics->bin_shift < bin_shift) {
+        int merged = (analytics->bin_count + 1) / 2;
+        for (int b = 0; b < merged; b++) {
+            const long *low = histograms + 2 * b * m;
+            const long *high = low + m;
+            bool has_high = 2 * b + 1 < analytics->bin_count;
+            for (size_t j = 0; j < m; j++) histograms[b * m + j] = low[j] + (has_high ? high[j] : 0);
+        }
+        analytics->bin_count = merged;
+        analytics->bin_shift++;
+    }
+
+    int bin_count = (score >> bin_shift) + 1;
+    if (bin_count <= analytics->bin_count) return 1;
+    if (!reserve_histograms(analytics, bin_count * m)) return 0;
+    memset(analytics->column_histograms + analytics->bin_count * m, 0,
+           (bin_count - analytics->bin_count) * m * sizeof(long));
+    analytics->bin_count = bin_count;
+    return 1;
+} // widen_score_histograms
+
+/**
+ * @brief Adds the counters of one partial result (e.g., one thread's) into another.
+ *
+ * Bins of different widths are brought to the wider of the two first.
+ *
+ * @param into Pointer to the accumulated analytics.
+ * @param from Pointer to the partial analytics; must have the same column count.
+ */
+void merge_score_analytics(ScoreAnalytics *into, const ScoreAnalytics *from) {
+    size_t m = into->column_count;
+    for (size_t j = 0; j < m; j++) {
+        into->match_counts[j] += from->match_counts[j];
+    }
+
+    widen_score_histograms(into, (from->bin_count - 1) << from->bin_shift, from->bin_shift);
+    for (int b = 0; b < from->bin_count; b++) {
+        int bin = (b << from->bin_shift) >> into->bin_shift;
+        if (bin >= into->bin_count) bin = into->bin_count - 1;
+        long *target = into->column_histograms + bin * m;
+        const long *source = from->column_histograms + b * m;
+        for (size_t j = 0; j < m; j++) target[j] += source[j];
+    }
+} // merge_score_analytics
+
+/**
+ * @brief Fills the counters from an existing score matrix.
+ *
+ * Used when the matrix was produced by a path that does not accumulate analytics
+ * while scoring (worker processes or a resumed checkpoint).
+ *
+ * @param analytics Pointer to the analytics, initialized for `m` columns.
+ * @param compatibility_scores Row-major `n x m` score matrix.
+ * @param n Number of rows.
+ * @param m Number of columns.
+ */
+void analyze_score_matrix(ScoreAnalytics *analytics, const int *compatibility_scores, int n, int m) {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) {
+            record_score(analytics, j, compatibility_scores[(size_t)i * m + j]);
+        }
+    }
+} // analyze_score_matrix
+
+/**
+ * @brief Makes room for the counts of `id_count` attribute ids; new counts are zero.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+static int reserve_attribute_counts(ScoreAnalytics *analytics, int id_count) {
+    if (id_count <= analytics->attribute_capacity) return 1;
+
+    int capacity = analytics->attribute_capacity ? analytics->attribute_capacity * 2 : 64;
+    while (capacity < id_count) capacity *= 2;
+    long *grown = realloc(analytics->attribute_counts, (size_t)capacity * 2 * sizeof(long));
+    if (!grown) {
+        perror("Failed to allocate memory for attribute overlaps");
+        return 0;
+    }
+    memset(grown + (size_t)analytics->attribute_capacity * 2, 0,
+           (size_t)(capacity - analytics->attribute_capacity) * 2 * sizeof(long));
+    analytics->attribute_counts = grown;
+    analytics->attribute_capacity = capacity;
+    return 1;
+} // reserve_attribute_counts
+
+/**
+ * @brief Keeps the attributes with the highest counted overlaps.
+ *
+ * Ranks ids with an insertion into a short sorted list and copies only the names
+ * of the attributes that make the final ranking.
+ */
+static int rank_counted_attributes(ScoreAnalytics *analytics, const AttributeDictionary *dictionary) {
+    for (int k = 0; k < analytics->top_overlap_count; k++) {
+        free(analytics->top_overlaps[k].attribute);
+    }
+    analytics->top_overlap_count = 0;
+
+    int top_ids[TOP_ATTRIBUTE_OVERLAPS];
+    long top_overlaps[TOP_ATTRIBUTE_OVERLAPS];
+    int top_count = 0;
+    const long *counts = analytics->attribute_counts;
+    for (int id = 0; id < dictionary->count; id++) {
+        long overlaps = counts[id * 2] * counts[id * 2 + 1];
+        if (overlaps == 0) continue;
+
+        int position = top_count;
+        while (position > 0 && top_overlaps[position - 1] < overlaps) position--;
+        if (position == TOP_ATTRIBUTE_OVERLAPS) continue;
+
+        if (top_count < TOP_ATTRIBUTE_OVERLAPS) top_count++;
+        memmove(&top_ids[position + 1], &top_ids[position], (top_count - position - 1) * sizeof(int));
+        memmove(&top_overlaps[position + 1], &top_overlaps[position], (top_count - position - 1) * sizeof(long));
+        top_ids[position] = id;
+        top_overlaps[position] = overlaps;
+    }
+
+    for (int k = 0; k < top_count; k++) {
+        char *attribute = strdup(attribute_name(dictionary, top_ids[k]));
+        if (!attribute) {
+            perror("Failed to allocate memory for attribute overlaps");
+            return 0;
+        }
+        analytics->top_overlaps[k] = (AttributeOverlap){.attribute = attribute, .overlaps = top_overlaps[k]};
+        analytics->top_overlap_count++;
+    }
+    return 1;
+} // rank_counted_attributes
+
+/**
+ * @brief Ranks the attributes that contribute the most to the compatibility scores.
+ *
+ * Works on attributes the caller has already interned, such as the ids a pairing
+ * context scored with, so no attribute string is hashed again.
+ *
+ * @param analytics Pointer to the analytics to be filled in.
+ * @param dictionary Dictionary the ids were interned into.
+ * @param ids1 Attribute ids of every row of the first dataset.
+ * @param count1 Number of ids in `ids1`.
+ * @param ids2 Attribute ids of every row of the second dataset.
+ * @param count2 Number of ids in `ids2`.
+ * @return 1 on success, 0 on failure.
+ */
+int rank_attribute_overlaps(ScoreAnalytics *analytics, const AttributeDictionary *dictionary, const int *ids1, size_t count1, const int *ids2, size_t count2) {
+    if (!reserve_attribute_counts(analytics, dictionary->count)) return 0;
+
+    long *counts = analytics->attribute_counts; // Occurrences in dataset1 and dataset2, interleaved per id
+    memset(counts, 0, (size_t)dictionary->count * 2 * sizeof(long));
+    for (size_t k = 0; k < count1; k++) counts[ids1[k] * 2]++;
+    for (size_t k = 0; k < count2; k++) counts[ids2[k] * 2 + 1]++;
+    return rank_counted_attributes(analytics, dictionary);
+} // rank_attribute_overlaps
+
+/**
+ * @brief Counts attribute occurrences in a dataset, interning new attributes.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+static int count_occurrences(ScoreAnalytics *analytics, AttributeDictionary *dictionary, const DataSet *dataset, int side) {
+    for (int i = 0; i < dataset->row_count; i++) {
+        for (int a = 0; a < dataset->rows[i].attributes_count; a++) {
+            int id = intern_attribute(dictionary, dataset->rows[i].attributes[a]);
+            if (id == -1 || !reserve_attribute_counts(analytics, id + 1)) return 0;
+            analytics->attribute_counts[id * 2 + side]++;
+        }
+    }
+    return 1;
+} // count_occurrences
+
+/**
+ * @brief Ranks the attributes that contribute the most to the compatibility scores.
+ *
+ * For matrices that were not scored on a pairing context (worker processes or a
+ * resumed checkpoint), whose attributes have not been interned yet.
+ *
+ * @param analytics Pointer to the analytics to be filled in.
+ * @param dataset1 Pointer to the first dataset.
+ * @param dataset2 Pointer to the second dataset.
+ * @return 1 on success, 0 on failure.
+ */
+int compute_attribute_overlaps(ScoreAnalytics *analytics, const DataSet *dataset1, const DataSet *dataset2) {
+    AttributeDictionary dictionary;
+    init_attribute_dictionary(&dictionary);
+    if (analytics->attribute_counts) {
+        memset(analytics->attribute_counts, 0, (size_t)analytics->attribute_capacity * 2 * sizeof(long));
+    }
+
+    int ok = count_occurrences(analytics, &dictionary, dataset1, 0) &&
+             count_occurrences(analytics, &dictionary, dataset2, 1) &&
+             rank_counted_attributes(analytics, &dictionary);
+
+    free_attribute_dictionary(&dictionary);
+    return ok;
+} // compute_attribute_overlaps
+
+/**
+ * @brief Frees the buffers held by an analytics structure.
+ *
+ * @param analytics Pointer to the analytics to be freed.
+ */
+void free_score_analytics(ScoreAnalytics *analytics) {
+    for (int k = 0; k < analytics->top_overlap_count; k++) {
+        free(analytics->top_overlaps[k].attribute);
+    }
+    free(analytics->match_counts);
+    free(analytics->column_histograms);
+    free(analytics->attribute_counts);
+    memset(analytics, 0, sizeof(*analytics));
+} // free_score_analytics
+
+/**
+ * @brief Writes the number of positive matches of each panel to a CSV file.
+ *
+ * @param filename Path to the output file.
+ * @param panels Dataset of panels/initiatives.
+ * @param analytics Analytics of the participant-panel score matrix.
+ * @return 1 on success, 0 on failure.
+ */
+int write_panel_popularity(const char *filename, DataSet *panels, const ScoreAnalytics *analytics) {
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        perror("Failed to open panel popularity file");
+        return 0;
+    }
+
+    fprintf(file, "Panel,Number of Matches\n");
+    for (int j = 0; j < panels->row_count; j++) {
+        fprintf(file, "%s,%ld\n", panels->rows[j].name, analytics->match_counts[j]);
+    }
+
+    fclose(file);
+    return 1;
+} // write_panel_popularity
+
+/**
+ * @brief Writes the score histogram of each column and of the whole matrix to a CSV file.
+ *
+ * @param filename Path to the output file.
+ * @param columns Dataset of mentors or panels.
+ * @param analytics Analytics of the score matrix.
+ * @return 1 on success, 0 on failure.
+ */
+int write_score_distribution(const char *filename, DataSet *columns, const ScoreAnalytics *analytics) {
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        perror("Failed to open score distribution file");
+        return 0;
+    }
+
+    size_t m = analytics->column_count;
+    int width = 1 << analytics->bin_shift;
+    fprintf(file, "Name");
+    for (int b = 0; b < analytics->bin_count; b++) {
+        if (width == 1) {
+            fprintf(file, ",Score %d", b);
+        } else {
+            fprintf(file, ",Score %d-%d", b * width, (b + 1) * width - 1);
+        }
+    }
+    fprintf(file, "\n");
+
+    for (size_t j = 0; j < m; j++) {
+        fprintf(file, "%s", columns->rows[j].name);
+        for (int b = 0; b < analytics->bin_count; b++) {
+            fprintf(file, ",%ld", analytics->column_histograms[b * m + j]);
+        }
+        fprintf(file, "\n");
+    }
+
+    // The overall histogram is the sum of the column histograms
+    fprintf(file, "Overall");
+    for (int b = 0; b < analytics->bin_count; b++) {
+        long overall = 0;
+        for (size_t j = 0; j < m; j++) overall += analytics->column_histograms[b * m + j];
+        fprintf(file, ",%ld", overall);
+    }
+    fprintf(file, "\n");
+
+    fclose(file);
+    return 1;
+} // write_score_distribution
+
+/**
+ * @brief Writes the attributes with the most overlaps to a CSV file.
+ *
+ * @param filename Path to the output file.
+ * @param analytics Analytics with a computed overlap ranking.
+ * @return 1 on success, 0 on failure.
+ */
+int write_attribute_overlaps(const char *filename, const ScoreAnalytics *analytics) {
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        perror("Failed to open attribute overlaps file");
+        return 0;
+    }
+
+    fprintf(file, "Attribute,Overlaps\n");
+    for (int k = 0; k < analytics->top_overlap_count; k++) {
+        fprintf(file, "%s,%ld\n", analytics->top_overlaps[k].attribute, analytics->top_overlaps[k].overlaps);
+    }
+
+    fclose(file);
+    return 1;
+} // write_attribute_overlaps
@@ -0,0 +1,82 @@
+/**
+ * @file score_analytics.h
+ * @brief Header file for score analytics gathered while scoring.
+ *
+ * Declares the counters used to describe a compatibility score matrix: how many
+ * positive matches each mentor or panel received, score histograms per column and
+ * overall, and the attributes responsible for the most overlaps. The counters are
+ * designed to be accumulated per thread during scoring and merged at the end, so
+ * no extra pass over the matrix is needed.
+ *
+ * Dependencies:
+ * - `attribute_dictionary.h`: Maps the interned ids used to rank attribute overlaps.
+ * - `input_parser.h`: Defines the `DataSet` structure.
+ */
+#ifndef SCORE_ANALYTICS_H
+#define SCORE_ANALYTICS_H
+
+#include <stddef.h>
+#include "attribute_dictionary.h"
+#include "input_parser.h"
+
+#define SCORE_HISTOGRAM_MAX_BINS 64 // Bins per column; higher scores share bins of a power-of-two width
+#define TOP_ATTRIBUTE_OVERLAPS 10 // Number of attributes reported by the overlap ranking
+
+/**
+ * @brief Number of attribute-equal pairs contributed by one attribute.
+ */
+typedef struct {
+    char *attribute;  ///< Attribute string
+    long overlaps;    ///< Number of (row, column) attribute pairs it matched
+} AttributeOverlap;
+
+/**
+ * @brief Counters describing a score matrix.
+ *
+ * Zero-initialize before the first call to `init_score_analytics`.
+ */
+typedef struct {
+    int column_count;                              ///< Columns (mentors or panels)
+    int column_capacity;                           ///< Columns the buffers can hold
+    long *match_counts;                            ///< Positive-score pairs per column
+    long *column_histograms;                       ///< `bin_count x column_count` counts, one row per bin
+    size_t histogram_capacity;                     ///< Counts `column_histograms` can hold
+    int bin_count;                                 ///< Bins in use; the last one holds the highest score seen
+    int bin_shift;                                 ///< Bin `b` counts scores `b << bin_shift` to `((b + 1) << bin_shift) - 1`
+    long *attribute_counts;                        ///< Occurrences of each attribute id on both sides, interleaved
+    int attribute_capacity;                        ///< Ids `attribute_counts` can hold
+    AttributeOverlap top_overlaps[TOP_ATTRIBUTE_OVERLAPS]; ///< Highest overlaps first
+    int top_overlap_count;                         ///< Entries used in `top_overlaps`
+} ScoreAnalytics;
+
+int widen_score_histograms(ScoreAnalytics *analytics, int score, int bin_shift);
+
+/**
+ * @brief Records one score of the matrix.
+ *
+ * Called from the scoring kernel, so it is defined here to be inlined. The bins
+ * grow with the highest score seen; should that fail, the score joins the last bin.
+ */
+static inline void record_score(ScoreAnalytics *analytics, int column, int score) {
+    int bin = score >> analytics->bin_shift;
+    if (bin >= analytics->bin_count) {
+        widen_score_histograms(analytics, score, analytics->bin_shift);
+        bin = score >> analytics->bin_shift;
+        if (bin >= analytics->bin_count) bin = analytics->bin_count - 1;
+    }
+    analytics->column_histograms[(size_t)bin * analytics->column_count + column]++;
+    analytics->match_counts[column] += score > 0;
+} // record_score
+
+// Function Declarations
+int init_score_analytics(ScoreAnalytics *analytics, int column_count);
+void merge_score_analytics(ScoreAnalytics *into, const ScoreAnalytics *from);
+void analyze_score_matrix(ScoreAnalytics *analytics, const int *compatibility_scores, int n, int m);
+int rank_attribute_overlaps(ScoreAnalytics *analytics, const AttributeDictionary *dictionary, const int *ids1, size_t count1, const int *ids2, size_t count2);
+int compute_attribute_overlaps(ScoreAnalytics *analytics, const DataSet *dataset1, const DataSet *dataset2);
+void free_score_analytics(ScoreAnalytics *analytics);
+int write_panel_popularity(const char *filename, DataSet *panels, const ScoreAnalytics *analytics);
+int write_score_distribution(const char *filename, DataSet *columns, const ScoreAnalytics *analytics);
+int write_attribute_overlaps(const char *filename, const ScoreAnalytics *analytics);
+
+#endif // SCORE_ANALYTICS_H
@@ -0,0 +1,80 @@
+/**
+ * @file score_matrix.c
+ * @brief Compatibility score matrix of a run.
+ *
+ * A matrix either takes its storage from an arena, or wraps storage produced
+ * elsewhere (a shared-memory mapping or a buffer loaded from a checkpoint)
+ * together with the function that frees it. Either way the scores are never
+ * copied once computed.
+ *
+ * Dependencies:
+ * - `score_matrix.h`: Declares the interface for this functionality.
+ */
+#include "score_matrix.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Creates a matrix whose storage, and the structure itself, come from an arena.
+ *
+ * @param arena Arena that owns the memory.
+ * @param rows Number of rows.
+ * @param columns Number of columns.
+ * @return Pointer to the matrix, or NULL on failure.
+ */
+ScoreMatrix *score_matrix_create(Arena *arena, int rows, int columns) {
+    size_t count = (size_t)rows * columns;
+    ScoreMatrix *matrix = arena_alloc(arena, sizeof(ScoreMatrix));
+    int *scores = arena_alloc(arena, count * sizeof(int));
+    if (!matrix || !scores) {
+        fprintf(stderr, "Failed to allocate memory for the score matrix.\n");
+        return NULL;
+    }
+
+    *matrix = (ScoreMatrix){.scores = scores, .rows = rows, .columns = columns, .in_arena = true};
+    return matrix;
+} // score_matrix_create
+
+/**
+ * @brief Takes ownership of existing storage without copying it.
+ *
+ * @param scores Row-major `rows x columns` scores.
+ * @param rows Number of rows.
+ * @param columns Number of columns.
+ * @param release_storage Function that frees `scores` in `score_matrix_free` (may be NULL).
+ * @return Pointer to the matrix, or NULL on failure
+ *         (the storage is released in that case).
+ */
+ScoreMatrix *score_matrix_wrap(int *scores, int rows, int columns, ScoreStorageRelease release_storage) {
+    ScoreMatrix *matrix = malloc(sizeof(ScoreMatrix));
+    if (!matrix) {
+        perror("Failed to allocate memory for the score matrix");
+        if (release_storage) release_storage(scores, (size_t)rows * columns * sizeof(int));
+        return NULL;
+    }
+
+    *matrix = (ScoreMatrix){.scores = scores, .rows = rows, .columns = columns, .release_storage = release_storage};
+    return matrix;
+} // score_matrix_wrap
+
+/**
+ * @brief Frees the matrix and its storage, except memory owned by an arena.
+ *
+ * @param matrix Pointer to the matrix (may be NULL).
+ */
+void score_matrix_free(ScoreMatrix *matrix) {
+    if (!matrix) return;
+
+    if (matrix->release_storage) {
+        matrix->release_storage(matrix->scores, (size_t)matrix->rows * matrix->columns * sizeof(int));
+    }
+    if (!matrix->in_arena) free(matrix);
+} // score_matrix_free
+
+/**
+ * @brief `ScoreStorageRelease` for storage obtained from `malloc`.
+ */
+void score_matrix_free_storage(int *scores, size_t size) {
+    (void)size;
+    free(scores);
+} // score_matrix_free_storage
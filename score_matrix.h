@@ -0,0 +1,53 @@
+/**
+ * @file score_matrix.h
+ * @brief Header file for the compatibility score matrix of a run.
+ *
+ * Declares the single owner of a run's score matrix. The stage that computes the
+ * scores creates the matrix once; every later stage (solver, writer, analytics,
+ * checkpoints) only reads it through a `const int *` view, and the run frees it
+ * at the end.
+ *
+ * Dependencies:
+ * - `arena.h`: Provides the arena that can own the matrix storage.
+ *
+ * Notes:
+ * - `score_matrix_free` releases wrapped storage; the memory of arena-backed
+ *   matrices goes with the arena.
+ */
+#ifndef SCORE_MATRIX_H
+#define SCORE_MATRIX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "arena.h"
+
+/**
+ * @brief Function that frees the storage of a wrapped matrix.
+ */
+typedef void (*ScoreStorageRelease)(int *scores, size_t size);
+
+/**
+ * @brief Row-major score matrix with a single owner.
+ */
+typedef struct {
+    int *scores;                          ///< `rows x columns` scores, row-major
+    int rows;                             ///< Number of rows (mentees or participants)
+    int columns;                          ///< Number of columns (mentors or panels)
+    ScoreStorageRelease release_storage;  ///< Frees `scores` in `score_matrix_free`, or NULL
+    bool in_arena;                        ///< Whether the structure itself lives in an arena
+} ScoreMatrix;
+
+// Function Declarations
+ScoreMatrix *score_matrix_create(Arena *arena, int rows, int columns);
+ScoreMatrix *score_matrix_wrap(int *scores, int rows, int columns, ScoreStorageRelease release_storage);
+void score_matrix_free(ScoreMatrix *matrix);
+void score_matrix_free_storage(int *scores, size_t size);
+
+/**
+ * @brief Returns a read-only view of one row of the matrix.
+ */
+static inline const int *score_matrix_row(const ScoreMatrix *matrix, int row) {
+    return matrix->scores + (size_t)row * matrix->columns;
+} // score_matrix_row
+
+#endif // SCORE_MATRIX_H
@@ -8,13 +8,25 @@
  * Dependencies:
  * - `solution_selector.h`: Declares the interface for these utilities.
  * - `input_parser.h`: Provides data structures for datasets of mentees and mentors.
+ * - `stable_matching.h`: Provides the parallel stable-matching engine.
+ * - `arena.h`: Provides the arena that solver buffers can be taken from.
+ * - `pairing.h`: Provides the scoring context timed by `measure_threading_performance`.
  */
 #include "solution_selector.h"
 #include "matching_engine.h"
+#include "pairing.h"
+#include "score_analytics.h"
+#include "stable_matching.h"
+#include "thread_pool.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
 #include <time.h>
+#include <unistd.h>
+
+#define CANCELLATION_CHECK_MASK 4095 // Mentees visited by the bucketed engine between cancellation checks
+#define BUCKET_SCAN_CHUNK 64         // Mentors per chunk when the bucketed engine rescans a row
+#define NON_THREADED_SAMPLE_ROWS 256  // Mentees scored to estimate the non-threaded time
 
 // Structure to store arrangement data
 typedef struct {
@@ -23,34 +35,100 @@ typedef struct {
 } Arrangement;
 
 /**
- * @brief Logs all evaluated arrangements and their scores to a file.
+ * @brief Allocates solver memory from the arena, or with `malloc` when there is none.
+ */
+static void *solver_alloc(Arena *arena, size_t size) {
+    if (size == 0) size = 1;
+    return arena ? arena_alloc(arena, size) : malloc(size);
+} // solver_alloc
+
+/**
+ * @brief Frees memory from `solver_alloc`; arena memory goes with its arena.
+ */
+static void solver_free(Arena *arena, void *memory) {
+    if (!arena) free(memory);
+} // solver_free
+
+/**
+ * @brief Opens an arrangement log and writes its header.
  *
- * @param arrangements Array of arrangements with their scores.
- * @param count Number of arrangements.
- * @param filename Path to the log file.
+ * @return The open file, or NULL if it could not be opened.
  */
-void log_arrangements(Arrangement *arrangements, int count, const char *filename) {
+static FILE *open_arrangement_log(const char *filename) {
     FILE *file = fopen(filename, "w");
     if (!file) {
         perror("Failed to open log file");
-        return;
+        return NULL;
     }
-
     fprintf(file, "Arrangement,Total Score\n");
-    for (int i = 0; i < count; i++) {
-        fprintf(file, "[");
-        for (int j = 0; j < count; j++) {
-            fprintf(file, "%d", arrangements[i].arrangement[j]);
-            if (j < count - 1) {
-                fprintf(file, ", ");
-            }
+    return file;
+} // open_arrangement_log
+
+/**
+ * @brief Writes one arrangement to the log.
+ *
+ * Only the first `prefix` mentees are taken from `assigned`; the rest are logged as
+ * unassigned. Lines are written as the solver produces them, so the log never has to
+ * be held in memory.
+ *
+ * @param file Open log file (may be NULL, in which case nothing is written).
+ * @param assigned Mentor index of each mentee (-1 when unmatched).
+ * @param prefix Number of leading mentees taken from `assigned`.
+ * @param length Number of mentees in the arrangement.
+ * @param total_score Score logged with the arrangement.
+ */
+static void write_arrangement(FILE *file, const int *assigned, int prefix, int length, int total_score) {
+    if (!file) return;
+    fprintf(file, "[");
+    for (int j = 0; j < length; j++) {
+        fprintf(file, "%d", j < prefix ? assigned[j] : -1);
+        if (j < length - 1) {
+            fprintf(file, ", ");
         }
-        fprintf(file, "], %d\n", arrangements[i].total_score);
+    }
+    fprintf(file, "], %d\n", total_score);
+} // write_arrangement
+
+/**
+ * @brief Logs all evaluated arrangements and their scores to a file.
+ *
+ * @param arrangements Array of arrangements with their scores.
+ * @param count Number of arrangements.
+ * @param length Number of mentees in each arrangement.
+ * @param filename Path to the log file.
+ */
+void log_arrangements(Arrangement *arrangements, int count, int length, const char *filename) {
+    FILE *file = open_arrangement_log(filename);
+    if (!file) return;
+
+    for (int i = 0; i < count; i++) {
+        write_arrangement(file, arrangements[i].arrangement, length, length, arrangements[i].total_score);
     }
 
     fclose(file);
 } // log_arrangements
 
+/**
+ * @brief Picks the best mentor with remaining capacity for one mentee.
+ *
+ * Returns the mentor with the highest compatibility score among those that still
+ * have capacity, preferring the lowest index on ties. Performs no allocation.
+ *
+ * @param score_row Compatibility scores of the mentee against every mentor.
+ * @param m Number of mentors.
+ * @param capacity_remaining Remaining capacity of each mentor.
+ * @return Index of the selected mentor, or -1 if every mentor is full.
+ */
+int select_best_mentor(const int *score_row, int m, const int *capacity_remaining) {
+    int best_col = -1;
+    for (int j = 0; j < m; j++) {
+        if (capacity_remaining[j] > 0 && (best_col == -1 || score_row[j] > score_row[best_col])) {
+            best_col = j;
+        }
+    }
+    return best_col;
+} // select_best_mentor
+
 /**
  * @brief Hungarian Algorithm with capacity constraints and arrangement logging.
  *
@@ -66,39 +144,73 @@ void log_arrangements(Arrangement *arrangements, int count, const char *filename
  *       Each index of `matches` corresponds to a mentee, and its value indicates the
  *       index of the matched mentor. If no match is found, the value is -1.
  */
-void select_optimal_matches(DataSet *mentees, DataSet *mentors, int *compatibility_scores, int **matches) {
+void select_optimal_matches(DataSet *mentees, DataSet *mentors, const int *compatibility_scores, int **matches) {
+    select_optimal_matches_with_options(mentees, mentors, compatibility_scores, matches, NULL);
+} // select_optimal_matches
+
+/**
+ * @brief Solves the assignment problem with optional resume and checkpoint support.
+ *
+ * Behaves like `select_optimal_matches`, but can continue from a previously saved
+ * `SolverState` and reports its progress every `checkpoint_interval` mentees so the
+ * caller can persist it. Resuming produces the same matches and arrangement log as
+ * an uninterrupted run. Once `cancel` fires, the remaining mentees are left
+ * unassigned; with `improve` set, the time left before that is spent on
+ * `improve_assignment` and the improved arrangement is logged last. Arrangements are
+ * written to the log as they are produced rather than kept in memory.
+ *
+ * @param mentees Pointer to the dataset of mentees.
+ * @param mentors Pointer to the dataset of mentors.
+ * @param compatibility_scores Pointer to the array of compatibility scores.
+ * @param matches Pointer to an array where the optimal matches will be stored.
+ * @param options Optional solver controls (may be NULL).
+ *
+ * @note The `matches` array comes from `options->arena` when one is given, and must
+ *       otherwise be freed by the caller.
+ */
+void select_optimal_matches_with_options(DataSet *mentees, DataSet *mentors, const int *compatibility_scores, int **matches, const SolverOptions *options) {
     int n = mentees->row_count; // Number of mentees
     int m = mentors->row_count; // Number of mentors
+    SolverState *resume_from = options ? options->resume_from : NULL;
+    CancellationToken *cancel = options ? options->cancel : NULL;
+    Arena *arena = options ? options->arena : NULL;
 
-    // Step 1: Initialize the cost matrix
-    int **cost = malloc(n * sizeof(int *));
-    for (int i = 0; i < n; i++) {
-        cost[i] = malloc(m * sizeof(int));
-        for (int j = 0; j < m; j++) {
-            cost[i][j] = -compatibility_scores[i * m + j]; // Convert to maximization problem
-        }
+    // Step 1: Initialize assignments and capacity tracking; the assignment becomes the matches
+    int *row_assigned = solver_alloc(arena, n * sizeof(int)); // Mentee to mentor
+    int *mentor_capacity_remaining = solver_alloc(arena, m * sizeof(int)); // Track remaining capacity for each mentor
+    if (!row_assigned || !mentor_capacity_remaining) {
+        perror("Failed to allocate memory for matches");
+        solver_free(arena, row_assigned);
+        solver_free(arena, mentor_capacity_remaining);
+        *matches = NULL;
+        return;
+    }
+    int start_row = 0;
+    if (resume_from) {
+        start_row = resume_from->next_row;
+        for (int i = 0; i < n; i++) row_assigned[i] = i < start_row ? resume_from->row_assigned[i] : -1;
+        for (int j = 0; j < m; j++) mentor_capacity_remaining[j] = resume_from->capacity_remaining[j];
+    } else {
+        for (int i = 0; i < n; i++) row_assigned[i] = -1;
+        for (int j = 0; j < m; j++) mentor_capacity_remaining[j] = mentors->rows[j].capacity;
     }
 
-    // Step 2: Initialize assignments and capacity tracking
-    int *row_assigned = malloc(n * sizeof(int)); // Mentee to mentor
-    int *mentor_capacity_remaining = malloc(m * sizeof(int)); // Track remaining capacity for each mentor
-    for (int i = 0; i < n; i++) row_assigned[i] = -1;
-    for (int j = 0; j < m; j++) mentor_capacity_remaining[j] = mentors->rows[j].capacity;
-
-    // Step 3: Solve the assignment problem while respecting capacities
-    Arrangement *arrangements = malloc(n * sizeof(Arrangement));
-    int arrangement_count = 0;
+    // Step 2: Solve the assignment problem while respecting capacities, logging each step
+    FILE *log_file = open_arrangement_log("arrangement_scores.log");
 
-    for (int i = 0; i < n; i++) {
-        int best_col = -1;
-        int best_value = INT_MAX;
+    // Rebuild the arrangements logged before the resume point
+    for (int i = 0; i < start_row; i++) {
+        write_arrangement(log_file, row_assigned, i + 1, n,
+                          row_assigned[i] != -1 ? compatibility_scores[i * m + row_assigned[i]] : -INT_MAX);
+    }
 
-        for (int j = 0; j < m; j++) {
-            if (cost[i][j] < best_value && mentor_capacity_remaining[j] > 0) {
-                best_value = cost[i][j];
-                best_col = j;
-            }
+    bool completed = true;
+    for (int i = start_row; i < n; i++) {
+        if (is_cancelled(cancel)) {
+            completed = false;
+            break;
         }
+        int best_col = select_best_mentor(&compatibility_scores[i * m], m, mentor_capacity_remaining);
 
         if (best_col != -1) {
             row_assigned[i] = best_col; // Assign the mentor to the mentee
@@ -106,71 +218,519 @@ void select_optimal_matches(DataSet *mentees, DataSet *mentors, int *compatibili
         }
 
         // Log arrangement
-        arrangements[arrangement_count].arrangement = malloc(n * sizeof(int));
-        for (int k = 0; k < n; k++) {
-            arrangements[arrangement_count].arrangement[k] = row_assigned[k];
+        write_arrangement(log_file, row_assigned, n, n, best_col != -1 ? compatibility_scores[i * m + best_col] : -INT_MAX);
+
+        // Report progress so the caller can checkpoint it
+        if (options && options->on_checkpoint && options->checkpoint_interval > 0 &&
+            (i + 1) % options->checkpoint_interval == 0 && i + 1 < n) {
+            SolverState state = {.next_row = i + 1,
+                                 .row_assigned = row_assigned,
+                                 .capacity_remaining = mentor_capacity_remaining};
+            options->on_checkpoint(&state, options->context);
         }
-        arrangements[arrangement_count].total_score = -best_value;
-        arrangement_count++;
     }
 
-    // Step 4: Generate matches
-    *matches = malloc(n * sizeof(int));
-    for (int i = 0; i < n; i++) {
-        (*matches)[i] = row_assigned[i];
+    // Use the time left before cancellation to improve the assignment
+    if (options && options->improve) {
+        SolverReport before;
+        evaluate_assignment(compatibility_scores, n, m, row_assigned, &before);
+        completed = improve_assignment(compatibility_scores, n, m, mentor_capacity_remaining, row_assigned, cancel) &&
+                    completed;
+
+        SolverReport after;
+        evaluate_assignment(compatibility_scores, n, m, row_assigned, &after);
+        if (after.objective != before.objective || after.assigned != before.assigned) {
+            write_arrangement(log_file, row_assigned, n, n, (int)after.objective);
+        }
+    }
+    if (options && options->report) {
+        evaluate_assignment(compatibility_scores, n, m, row_assigned, options->report);
+        options->report->completed = completed;
+    }
+    if (log_file) fclose(log_file);
+
+    // Step 3: Hand the assignment over as the matches
+    *matches = row_assigned;
+    solver_free(arena, mentor_capacity_remaining);
+} // select_optimal_matches_with_options
+
+/**
+ * @brief Grows the bucket scratch buffer so it can hold `count` ints.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+static int reserve_bucket_scratch(BucketScratch *scratch, size_t count) {
+    if (count <= scratch->capacity) return 1;
+
+    // Contents need not survive growth, so an arena buffer is simply replaced
+    int *buffer = scratch->arena ? arena_alloc(scratch->arena, count * sizeof(int))
+                                 : realloc(scratch->buffer, count * sizeof(int));
+    if (!buffer) {
+        perror("Failed to allocate memory for score buckets");
+        return 0;
+    }
+    scratch->buffer = buffer;
+    scratch->capacity = count;
+    return 1;
+} // reserve_bucket_scratch
+
+/**
+ * @brief Returns the highest score of a row among the open mentors of one chunk.
+ *
+ * `open` holds -1 for mentors with capacity left and 0 for full ones, so masking
+ * needs no branch. Full chunks run a loop of constant length, which the compiler
+ * vectorizes; only the last chunk of a row may be shorter.
+ *
+ * @param score_row Scores of the mentee against every mentor.
+ * @param open Mask of the open mentors.
+ * @param chunk Index of the chunk of `BUCKET_SCAN_CHUNK` mentors.
+ * @param m Number of mentors.
+ * @return The highest score, or 0 if no open mentor in the chunk has a positive score.
+ */
+static int open_chunk_max(const int *score_row, const int *open, int chunk, int m) {
+    int first = chunk * BUCKET_SCAN_CHUNK;
+    const int *scores = score_row + first;
+    const int *mask = open + first;
+    int best = 0;
+    if (first + BUCKET_SCAN_CHUNK <= m) {
+        for (int j = 0; j < BUCKET_SCAN_CHUNK; j++) {
+            int score = scores[j] & mask[j];
+            best = score > best ? score : best;
+        }
+    } else {
+        for (int j = 0; j < m - first; j++) {
+            int score = scores[j] & mask[j];
+            best = score > best ? score : best;
+        }
+    }
+    return best;
+} // open_chunk_max
+
+/**
+ * @brief Whether the bucketed sweep takes mentee `a` before mentee `b`: higher key first, then lower row.
+ */
+static inline bool sweeps_before(const int *keys, int a, int b) {
+    return keys[a] > keys[b] || (keys[a] == keys[b] && a < b);
+} // sweeps_before
+
+/**
+ * @brief Moves the mentee at `position` of the sweep heap down to its place.
+ */
+static void sift_sweep_heap(int *heap, int count, int position, const int *keys) {
+    int row = heap[position];
+    for (;;) {
+        int child = 2 * position + 1;
+        if (child >= count) break;
+        if (child + 1 < count && sweeps_before(keys, heap[child + 1], heap[child])) child++;
+        if (!sweeps_before(keys, heap[child], row)) break;
+        heap[position] = heap[child];
+        position = child;
     }
+    heap[position] = row;
+} // sift_sweep_heap
 
-    // Log all arrangements to file
-    log_arrangements(arrangements, arrangement_count, "arrangement_scores.log");
+/**
+ * @brief Greedy assignment over all pairs, highest score first.
+ *
+ * Produces the assignment of a walk over every positive (mentee, mentor) pair from the
+ * highest score down that assigns a pair whenever the mentee is still unassigned and
+ * the mentor still has capacity, taking ties in mentee, then mentor, order. Rather
+ * than sorting the pairs, it sweeps the mentees by their best remaining score, from
+ * the highest down and in row order within a score, each taking the first mentor with
+ * capacity at that score. One pass over the matrix records the maximum of every chunk
+ * of `BUCKET_SCAN_CHUNK` mentors of each row; since mentors only fill up, these stay
+ * upper bounds, so a mentee only rescans the chunks that may still reach its score. A
+ * mentee whose mentors at that score are full drops to its highest remaining bound.
+ * The mentees wait in a binary heap keyed by that score, so the sweep costs
+ * O(log n) per visit however many distinct scores there are, as with weighted scores,
+ * and the scratch space is two ints per mentee, one per mentor and one per chunk.
+ *
+ * Mentees left over can only reach mentors they share no attributes with, so they are
+ * given the first mentors with capacity left. If `cancel` fires, the sweep is abandoned
+ * and the leftover mentees are placed the same way, so the result is always feasible.
+ *
+ * @param compatibility_scores Row-major `n x m` score matrix.
+ * @param n Number of mentees.
+ * @param m Number of mentors.
+ * @param capacity_remaining Capacity of each mentor; updated in place.
+ * @param row_assigned Output array of `n` mentor indices (-1 when unmatched).
+ * @param scratch Reusable scratch buffers.
+ * @param cancel Token that stops the walk early (may be NULL).
+ * @return 1 on success, 0 on failure.
+ */
+int assign_by_score_buckets(const int *compatibility_scores, int n, int m, int *capacity_remaining, int *row_assigned, BucketScratch *scratch, CancellationToken *cancel) {
+    for (int i = 0; i < n; i++) row_assigned[i] = -1;
+    int chunks = (m + BUCKET_SCAN_CHUNK - 1) / BUCKET_SCAN_CHUNK;
+    if (!reserve_bucket_scratch(scratch, (size_t)n * (chunks + 2) + m + 1)) return 0;
+    int *best_scores = scratch->buffer;
+    int *heap = best_scores + n;
+    int *open = heap + n;
+    int *chunk_bounds = open + m;
 
-    // Cleanup
-    for (int i = 0; i < arrangement_count; i++) {
-        free(arrangements[i].arrangement);
+    long capacity_left = 0;
+    for (int j = 0; j < m; j++) {
+        open[j] = capacity_remaining[j] > 0 ? -1 : 0;
+        if (capacity_remaining[j] > 0) capacity_left += capacity_remaining[j];
     }
-    free(arrangements);
 
+    // Step 1: Record the maximum of every chunk of every row, and the best score of each mentee
+    int queued = 0;
     for (int i = 0; i < n; i++) {
-        free(cost[i]);
+        const int *score_row = compatibility_scores + (size_t)i * m;
+        int *bounds = chunk_bounds + (size_t)i * chunks;
+        best_scores[i] = 0;
+        for (int c = 0; c < chunks; c++) {
+            bounds[c] = open_chunk_max(score_row, open, c, m);
+            if (bounds[c] > best_scores[i]) best_scores[i] = bounds[c];
+        }
+        if (best_scores[i] > 0) heap[queued++] = i;
     }
-    free(cost);
-    free(row_assigned);
-    free(mentor_capacity_remaining);
-} // select_optimal_matches
+    for (int position = queued / 2 - 1; position >= 0; position--) {
+        sift_sweep_heap(heap, queued, position, best_scores);
+    }
+
+    // Step 2: Take the mentee with the highest best score, lowest row first, until no mentee
+    // can reach an open mentor with a positive score
+    int unassigned = n;
+    long visited = 0;
+    while (queued > 0 && capacity_left > 0) {
+        if ((visited++ & CANCELLATION_CHECK_MASK) == 0 && is_cancelled(cancel)) break;
+        int i = heap[0];
+        int score = best_scores[i];
+
+        // Mentors only ever fill up, so a recorded chunk maximum stays an upper bound: the
+        // mentor to take is in the first chunk whose bound is still the mentee's best score
+        const int *score_row = compatibility_scores + (size_t)i * m;
+        int *bounds = chunk_bounds + (size_t)i * chunks;
+        int taken = -1;
+        for (int c = 0; c < chunks && taken == -1; c++) {
+            if (bounds[c] < score) continue;
+            bounds[c] = open_chunk_max(score_row, open, c, m);
+            if (bounds[c] < score) continue;
+            taken = c * BUCKET_SCAN_CHUNK;
+            while ((score_row[taken] & open[taken]) != score) taken++;
+        }
+
+        best_scores[i] = 0;
+        if (taken != -1) {
+            row_assigned[i] = taken;
+            if (--capacity_remaining[taken] == 0) open[taken] = 0;
+            capacity_left--;
+            unassigned--;
+        } else {
+            // Every open mentor at this score is taken: the mentee drops to its highest bound,
+            // which is below `score`, and if that bound has gone stale too it drops again later
+            for (int c = 0; c < chunks; c++) {
+                if (bounds[c] > best_scores[i]) best_scores[i] = bounds[c];
+            }
+        }
+        if (best_scores[i] == 0) heap[0] = heap[--queued];
+        if (queued > 0) sift_sweep_heap(heap, queued, 0, best_scores);
+    }
+
+    // Step 3: Remaining mentees score zero with every mentor that still has capacity
+    for (int i = 0, j = 0; i < n && unassigned > 0; i++) {
+        if (row_assigned[i] != -1) continue;
+        while (j < m && capacity_remaining[j] <= 0) j++;
+        if (j == m) break;
+        row_assigned[i] = j;
+        capacity_remaining[j]--;
+        unassigned--;
+    }
+    return 1;
+} // assign_by_score_buckets
+
+/**
+ * @brief Frees the buffer held by a bucket scratch structure.
+ *
+ * A buffer taken from an arena is left to the arena.
+ *
+ * @param scratch Pointer to the scratch structure.
+ */
+void free_bucket_scratch(BucketScratch *scratch) {
+    if (!scratch->arena) free(scratch->buffer);
+    *scratch = (BucketScratch){0};
+} // free_bucket_scratch
+
+/**
+ * @brief Score-bucketed greedy assignment with capacity constraints.
+ *
+ * Pipeline counterpart of `select_optimal_matches` that uses `assign_by_score_buckets`,
+ * so the result does not depend on the order of the mentees in the input. The final
+ * arrangement and its total score are written to the arrangement log.
+ *
+ * @param mentees Pointer to the dataset of mentees.
+ * @param mentors Pointer to the dataset of mentors.
+ * @param compatibility_scores Pointer to the array of compatibility scores.
+ * @param matches Pointer to an array where the matches will be stored.
+ * @param options Optional solver controls (may be NULL); resuming and checkpoints
+ *                do not apply to this engine.
+ *
+ * @note The `matches` array comes from `options->arena` when one is given, and must
+ *       otherwise be freed by the caller.
+ */
+void select_bucketed_matches(DataSet *mentees, DataSet *mentors, const int *compatibility_scores, int **matches, const SolverOptions *options) {
+    int n = mentees->row_count;
+    int m = mentors->row_count;
+    Arena *arena = options ? options->arena : NULL;
+
+    *matches = solver_alloc(arena, n * sizeof(int));
+    int *mentor_capacity_remaining = solver_alloc(arena, m * sizeof(int));
+    if (!*matches || !mentor_capacity_remaining) {
+        perror("Failed to allocate memory for matches");
+        solver_free(arena, *matches);
+        solver_free(arena, mentor_capacity_remaining);
+        *matches = NULL;
+        return;
+    }
+    for (int j = 0; j < m; j++) mentor_capacity_remaining[j] = mentors->rows[j].capacity;
+
+    CancellationToken *cancel = options ? options->cancel : NULL;
+    BucketScratch scratch = {.arena = arena};
+    if (!assign_by_score_buckets(compatibility_scores, n, m, mentor_capacity_remaining, *matches, &scratch, cancel)) {
+        solver_free(arena, *matches);
+        *matches = NULL;
+    } else {
+        bool completed = !is_cancelled(cancel);
+        if (options && options->improve) {
+            completed = improve_assignment(compatibility_scores, n, m, mentor_capacity_remaining, *matches, cancel) &&
+                        completed;
+        }
+        if (options && options->report) {
+            evaluate_assignment(compatibility_scores, n, m, *matches, options->report);
+            options->report->completed = completed;
+        }
+
+        Arrangement arrangement = {.arrangement = *matches, .total_score = 0};
+        for (int i = 0; i < n; i++) {
+            if ((*matches)[i] != -1) arrangement.total_score += compatibility_scores[i * m + (*matches)[i]];
+        }
+        log_arrangements(&arrangement, 1, n, "arrangement_scores.log");
+    }
+
+    free_bucket_scratch(&scratch);
+    solver_free(arena, mentor_capacity_remaining);
+} // select_bucketed_matches
 
 /**
- * @brief Measures the execution time of threaded and non-threaded matching algorithms.
+ * @brief Stable assignment with capacity constraints.
  *
- * This function compares the performance of threaded and non-threaded versions of
- * `match_mentees_to_mentors`, displaying the time taken for each approach.
+ * Pipeline counterpart of `assign_stable_matching`, run on a pool with one worker per
+ * online CPU. The result maximizes stability rather than the total score, so the
+ * `improve` option is ignored: local search would reintroduce blocking pairs. The
+ * final arrangement and its total score are written to the arrangement log.
  *
  * @param mentees Pointer to the dataset of mentees.
  * @param mentors Pointer to the dataset of mentors.
  * @param compatibility_scores Pointer to the array of compatibility scores.
+ * @param matches Pointer to an array where the matches will be stored.
+ * @param options Optional solver controls (may be NULL); only `cancel` and `report` apply.
+ *
+ * @note The `matches` array comes from `options->arena` when one is given, and must
+ *       otherwise be freed by the caller.
+ */
+void select_stable_matches(DataSet *mentees, DataSet *mentors, const int *compatibility_scores, int **matches, const SolverOptions *options) {
+    int n = mentees->row_count;
+    int m = mentors->row_count;
+    Arena *arena = options ? options->arena : NULL;
+
+    *matches = solver_alloc(arena, n * sizeof(int));
+    int *capacities = solver_alloc(arena, m * sizeof(int));
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    ThreadPool *pool = thread_pool_create(cpus > 0 ? (int)cpus : 1);
+    if (!*matches || !capacities || !pool) {
+        perror("Failed to allocate memory for matches");
+        solver_free(arena, *matches);
+        solver_free(arena, capacities);
+        if (pool) thread_pool_destroy(pool);
+        *matches = NULL;
+        return;
+    }
+    for (int j = 0; j < m; j++) capacities[j] = mentors->rows[j].capacity;
+
+    CancellationToken *cancel = options ? options->cancel : NULL;
+    StableScratch scratch = {0};
+    if (!assign_stable_matching(compatibility_scores, n, m, capacities, *matches, pool, &scratch, cancel)) {
+        solver_free(arena, *matches);
+        *matches = NULL;
+    } else {
+        if (options && options->report) {
+            evaluate_assignment(compatibility_scores, n, m, *matches, options->report);
+            options->report->completed = !is_cancelled(cancel);
+        }
+
+        Arrangement arrangement = {.arrangement = *matches, .total_score = 0};
+        for (int i = 0; i < n; i++) {
+            if ((*matches)[i] != -1) arrangement.total_score += compatibility_scores[i * m + (*matches)[i]];
+        }
+        log_arrangements(&arrangement, 1, n, "arrangement_scores.log");
+    }
+
+    free_stable_scratch(&scratch);
+    thread_pool_destroy(pool);
+    solver_free(arena, capacities);
+} // select_stable_matches
+
+/**
+ * @brief Local search that improves a feasible assignment until cancelled.
+ *
+ * Repeatedly moves a mentee to a mentor with spare capacity and a higher score, or
+ * exchanges the mentors of two mentees when that raises their combined score. Every
+ * step keeps the assignment feasible and strictly improves it, so the search can be
+ * stopped at any point and always ends at a local optimum if left to run.
+ *
+ * @param compatibility_scores Row-major `n x m` score matrix.
+ * @param n Number of mentees.
+ * @param m Number of mentors.
+ * @param capacity_remaining Remaining capacity of each mentor; updated in place.
+ * @param row_assigned Assignment to improve in place (-1 when unmatched).
+ * @param cancel Token that stops the search (may be NULL).
+ * @return 1 if no improving step is left, 0 if cancellation stopped the search first.
+ */
+int improve_assignment(const int *compatibility_scores, int n, int m, int *capacity_remaining, int *row_assigned, CancellationToken *cancel) {
+    bool improved = true;
+    while (improved) {
+        improved = false;
+        for (int i = 0; i < n; i++) {
+            if (is_cancelled(cancel)) return 0;
+
+            const int *row = compatibility_scores + (size_t)i * m;
+            int current = row_assigned[i];
+
+            // Move to a better mentor that still has capacity
+            int best = select_best_mentor(row, m, capacity_remaining);
+            if (best != -1 && (current == -1 || row[best] > row[current])) {
+                if (current != -1) capacity_remaining[current]++;
+                capacity_remaining[best]--;
+                row_assigned[i] = current = best;
+                improved = true;
+            }
+            if (current == -1) continue;
+
+            // Exchange mentors with a later mentee when the pair gains in total
+            for (int k = i + 1; k < n; k++) {
+                int other = row_assigned[k];
+                if (other == -1 || other == current) continue;
+
+                const int *other_row = compatibility_scores + (size_t)k * m;
+                if (row[other] + other_row[current] > row[current] + other_row[other]) {
+                    row_assigned[k] = current;
+                    row_assigned[i] = current = other;
+                    improved = true;
+                }
+            }
+        }
+    }
+    return 1;
+} // improve_assignment
+
+/**
+ * @brief Measures an assignment against the capacity-free upper bound.
+ *
+ * @param compatibility_scores Row-major `n x m` score matrix.
+ * @param n Number of mentees.
+ * @param m Number of mentors.
+ * @param row_assigned Assignment of each mentee (-1 when unmatched).
+ * @param report Pointer to the report to be filled in; `completed` is set to true.
+ */
+void evaluate_assignment(const int *compatibility_scores, int n, int m, const int *row_assigned, SolverReport *report) {
+    *report = (SolverReport){.completed = true};
+    for (int i = 0; i < n; i++) {
+        const int *row = compatibility_scores + (size_t)i * m;
+        int best = 0;
+        for (int j = 0; j < m; j++) {
+            if (row[j] > best) best = row[j];
+        }
+        report->upper_bound += best;
+        if (row_assigned[i] != -1) {
+            report->objective += row[row_assigned[i]];
+            report->assigned++;
+        }
+    }
+    report->gap = report->upper_bound > 0
+                      ? (double)(report->upper_bound - report->objective) / report->upper_bound
+                      : 0.0;
+} // evaluate_assignment
+
+/**
+ * @brief Reports the run's scoring time against a single-threaded estimate.
+ *
+ * Takes the time the pipeline actually spent scoring, so the matrix is not computed
+ * again just to be timed. The single-threaded time comes from scoring up to
+ * `NON_THREADED_SAMPLE_ROWS` evenly spaced mentees on this thread with the same code
+ * the run used, and scaling to every mentee; with fewer mentees than that it is exact.
+ * In-process scoring is repeated on a one-thread `PairingContext`, analytics included;
+ * with worker processes, the workers' `calculate_score` kernel is followed by the
+ * analytics pass the pipeline runs on their matrix.
+ *
+ * @param mentees Pointer to the dataset of mentees.
+ * @param mentors Pointer to the dataset of mentors.
+ * @param scoring_time Seconds the pipeline spent computing the score matrix and its analytics.
+ * @param num_workers Number of worker processes that scored, or 0 for the in-process thread pool.
  */
-void measure_threading_performance(DataSet *mentees, DataSet *mentors, int *compatibility_scores) {
+void measure_threading_performance(DataSet *mentees, DataSet *mentors, double scoring_time, int num_workers) {
     struct timespec start, end;
-    double threaded_time, non_threaded_time;
+    int n = mentees->row_count;
+    int m = mentors->row_count;
+    int sample_rows = n < NON_THREADED_SAMPLE_ROWS ? n : NON_THREADED_SAMPLE_ROWS;
 
-    // Threaded execution
-    clock_gettime(CLOCK_MONOTONIC, &start);
-    match_datasets(mentees, mentors, &compatibility_scores); // Threaded version
-    clock_gettime(CLOCK_MONOTONIC, &end);
-    threaded_time = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    // The sample shares the rows of the mentees, so only the row array is allocated
+    DataSet sample = {.row_count = sample_rows, .rows = malloc((sample_rows > 0 ? sample_rows : 1) * sizeof(DataRow))};
+    int *sample_scores = malloc(((size_t)sample_rows * m > 0 ? (size_t)sample_rows * m : 1) * sizeof(int));
+    PairingContext *context = num_workers > 0 ? NULL : pairing_create(1);
+    ScoreAnalytics analytics = {0};
+    if (!sample.rows || !sample_scores || (num_workers <= 0 && !context)) {
+        perror("Failed to allocate memory for threading performance");
+        free(sample.rows);
+        free(sample_scores);
+        pairing_destroy(context);
+        return;
+    }
+    for (int k = 0; k < sample_rows; k++) sample.rows[k] = mentees->rows[(long)n * k / sample_rows];
 
-    // Non-threaded execution
+    // Single-threaded execution over the sampled rows
+    int ok = 1;
     clock_gettime(CLOCK_MONOTONIC, &start);
-    match_datasets(mentees, mentors, &compatibility_scores); // Non-threaded version
+    if (context) {
+        ok = pairing_score_with_analytics(context, &sample, mentors, sample_scores, &analytics);
+    } else {
+        for (int k = 0; k < sample_rows; k++) {
+            for (int j = 0; j < m; j++) {
+                sample_scores[(size_t)k * m + j] = calculate_score(&sample.rows[k], &mentors->rows[j]);
+            }
+        }
+        ok = init_score_analytics(&analytics, m);
+        if (ok) analyze_score_matrix(&analytics, sample_scores, sample_rows, m);
+        if (ok) ok = compute_attribute_overlaps(&analytics, &sample, mentors);
+    }
     clock_gettime(CLOCK_MONOTONIC, &end);
-    non_threaded_time = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    double single_time = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    if (sample_rows > 0) single_time *= (double)n / sample_rows;
+    free_score_analytics(&analytics);
+    pairing_destroy(context);
+    free(sample.rows);
+    free(sample_scores);
+    if (!ok) {
+        fprintf(stderr, "Error: Failed to measure the single-threaded scoring time.\n");
+        return;
+    }
 
     // Log results
-    printf("Threaded Execution Time: %.6f seconds\n", threaded_time);
-    printf("Non-Threaded Execution Time: %.6f seconds\n", non_threaded_time);
+    char scored[64];
+    if (num_workers > 0) {
+        snprintf(scored, sizeof(scored), "Sharded Execution Time (%d workers)", num_workers);
+    } else {
+        snprintf(scored, sizeof(scored), "Threaded Execution Time");
+    }
+    printf("%s: %.6f seconds\n", scored, scoring_time);
+    printf("Non-Threaded Execution Time: %.6f seconds\n", single_time);
+    if (sample_rows < n) printf("(Non-threaded time estimated from %d of %d mentees.)\n", sample_rows, n);
 
     FILE *log_file = fopen("threading_performance.log", "w");
     if (log_file) {
-        fprintf(log_file, "Threaded Execution Time: %.6f seconds\n", threaded_time);
-        fprintf(log_file, "Non-Threaded Execution Time: %.6f seconds\n", non_threaded_time);
+        fprintf(log_file, "%s: %.6f seconds\n", scored, scoring_time);
+        fprintf(log_file, "Non-Threaded Execution Time: %.6f seconds\n", single_time);
+        if (sample_rows < n) fprintf(log_file, "(Non-threaded time estimated from %d of %d mentees.)\n", sample_rows, n);
         fclose(log_file);
     } else {
         perror("Failed to open threading performance log file");
@@ -10,15 +10,91 @@
  * Dependencies:
  * - `input_parser.h`: Defines the `DataSet` and `DataRow` structures used for input data.
  * - `utils.h`: Assumed to contain utility functions for operations like memory management and debugging.
+ * - `synchronization.h`: Defines the `CancellationToken` that bounds a solve.
+ * - `arena.h`: Defines the `Arena` that solver buffers can be taken from.
  *
  */
 #ifndef SOLUTION_SELECTOR_H
 #define SOLUTION_SELECTOR_H
+#include <stdbool.h>
+#include <stddef.h>
+#include "arena.h"
 #include "input_parser.h"
+#include "synchronization.h"
+
+/**
+ * @brief Assignment engines available to the pipeline.
+ */
+typedef enum {
+    SOLVER_SEQUENTIAL = 0,  ///< Mentees in input order, each taking its best mentor with capacity
+    SOLVER_BUCKETED = 1,    ///< Global pass over all pairs from highest to lowest score
+    SOLVER_STABLE = 2       ///< Mentee-optimal stable matching (capacitated Gale-Shapley)
+} SolverKind;
+
+/**
+ * @brief Reusable scratch space for the bucketed engine.
+ *
+ * Holds two ints per mentee, one per mentor and one per chunk of each mentee's row. The
+ * buffer only grows; zero-initialize before first use (and set `arena` to take it from
+ * an arena) and release with `free_bucket_scratch`.
+ */
+typedef struct {
+    int *buffer;      ///< Best score of each mentee, the sweep heap, the open mentors, then the chunk bounds of each row
+    size_t capacity;  ///< Allocated length of `buffer`, in ints
+    Arena *arena;     ///< Source of the buffer, or NULL for `malloc`
+} BucketScratch;
+
+/**
+ * @brief Partial state of the assignment solver.
+ *
+ * Captures everything needed to continue an interrupted solve: mentees before
+ * `next_row` have been assigned and mentor capacities reflect those assignments.
+ */
+typedef struct {
+    int next_row;             ///< First mentee that has not been assigned yet
+    int *row_assigned;        ///< Mentee to mentor assignment (-1 when unassigned)
+    int *capacity_remaining;  ///< Remaining capacity for each mentor
+} SolverState;
+
+/**
+ * @brief Quality of an assignment returned by a solver.
+ *
+ * The upper bound gives every mentee its best score and ignores capacities, so
+ * no feasible assignment can exceed it.
+ */
+typedef struct {
+    long objective;    ///< Total score of the assignment
+    long upper_bound;  ///< Sum over mentees of their highest score
+    double gap;        ///< (upper_bound - objective) / upper_bound, or 0 when the bound is 0
+    int assigned;      ///< Number of mentees with a mentor
+    bool completed;    ///< false if cancellation cut the solve short
+} SolverReport;
+
+/**
+ * @brief Optional controls for a solver run.
+ */
+typedef struct {
+    SolverState *resume_from;  ///< State to continue from, or NULL to start fresh
+    int checkpoint_interval;   ///< Mentees between `on_checkpoint` calls (0 disables)
+    void (*on_checkpoint)(const SolverState *state, void *context); ///< Progress callback
+    void *context;             ///< User data passed to `on_checkpoint`
+    CancellationToken *cancel; ///< Stops the solve early, keeping the assignment so far (may be NULL)
+    bool improve;              ///< Spend the time left before `cancel` fires on local search
+    SolverReport *report;      ///< Filled in with the quality of the result (may be NULL)
+    Arena *arena;              ///< Source of the matches and working buffers, or NULL for `malloc`
+} SolverOptions;
 
 // Function Declarations
-void select_optimal_matches(DataSet *mentees, DataSet *mentors, int *compatibility_scores, int **matches);
-void measure_threading_performance(DataSet *mentees, DataSet *mentors, int *compatibility_scores);
+int select_best_mentor(const int *score_row, int m, const int *capacity_remaining);
+void select_optimal_matches(DataSet *mentees, DataSet *mentors, const int *compatibility_scores, int **matches);
+void select_optimal_matches_with_options(DataSet *mentees, DataSet *mentors, const int *compatibility_scores, int **matches, const SolverOptions *options);
+int assign_by_score_buckets(const int *compatibility_scores, int n, int m, int *capacity_remaining, int *row_assigned, BucketScratch *scratch, CancellationToken *cancel);
+void free_bucket_scratch(BucketScratch *scratch);
+void select_bucketed_matches(DataSet *mentees, DataSet *mentors, const int *compatibility_scores, int **matches, const SolverOptions *options);
+void select_stable_matches(DataSet *mentees, DataSet *mentors, const int *compatibility_scores, int **matches, const SolverOptions *options);
+int improve_assignment(const int *compatibility_scores, int n, int m, int *capacity_remaining, int *row_assigned, CancellationToken *cancel);
+void evaluate_assignment(const int *compatibility_scores, int n, int m, const int *row_assigned, SolverReport *report);
+void measure_threading_performance(DataSet *mentees, DataSet *mentors, double scoring_time, int num_workers);
 void match_mentees_to_mentors_non_threaded(DataSet *mentees, DataSet *mentors, int **compatibility_scores);
 
 #endif // SOLUTION_SELECTOR_H
\ No newline at end of file
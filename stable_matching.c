@@ -0,0 +1,341 @@
+/**
+ * @file stable_matching.c
+ * @brief Parallel hospitals/residents Gale-Shapley with lock-free proposals.
+ *
+ * Each mentor keeps the mentees it holds in a skew heap with its worst accepted
+ * mentee at the root, linked through two ints per mentee, so memory is O(n + m)
+ * whatever the capacities. A mentee's score with a mentor and its index are packed
+ * into one ordered key, so ranking never touches the holder's row of the matrix. Once
+ * a mentor is full, the key of its worst accepted mentee is published in an atomic
+ * threshold that only rises: a proposal below it is rejected with one atomic load,
+ * and only a proposal that will be accepted takes the mentor's lock, to update the
+ * heap in O(log c) amortized and raise the threshold.
+ *
+ * Preferences are kept as a short window per mentee, filled by partially sorting the
+ * mentee's score row on the worker pool and refilled on demand. Proposals run in
+ * rounds: every free mentee proposes down its list until a mentor accepts it, and the
+ * mentees it displaces propose in the next round. Mentee-proposing deferred acceptance
+ * reaches the same matching in any proposal order, so the result is deterministic.
+ *
+ * Dependencies:
+ * - `stable_matching.h`: Declares the interface for this functionality.
+ */
+#include "stable_matching.h"
+#include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MENTEES_PER_TASK 64 // Free mentees handled by one pool task per round
+#define NO_THRESHOLD 0ULL   // Threshold of a mentor with room left; every key beats it
+
+/**
+ * @brief State shared by every task of a run.
+ */
+typedef struct {
+    const int *compatibility_scores;
+    int n;
+    int m;
+    const int *capacities;
+    MentorState *mentors;
+    HeldMentee *held;
+    int *row_assigned;
+    MenteePreferences *preferences;
+    int *windows;
+    const int *current;      // Mentees proposing in this round
+    int current_count;
+    int *next;               // Mentees displaced during this round
+    atomic_int next_count;
+    CancellationToken *cancel;
+} StableRun;
+
+/**
+ * @brief Grows a buffer so it can hold at least `count` elements.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+static int reserve_buffer(void **buffer, size_t *capacity, size_t count, size_t element_size) {
+    if (count <= *capacity) return 1;
+    void *grown = realloc(*buffer, count * element_size);
+    if (!grown) {
+        perror("Failed to allocate memory for stable matching");
+        return 0;
+    }
+    *buffer = grown;
+    *capacity = count;
+    return 1;
+} // reserve_buffer
+
+/**
+ * @brief Loads the next best mentors after the cursor into a mentee's window.
+ *
+ * Mentors tied with the cursor's score come next in index order, so the window is
+ * first continued along that tie run, which costs only the distance scanned. Any
+ * room left goes to the best mentors below that score, selected by insertion into
+ * the short sorted window in O(m) for a typical row. Scores take few distinct
+ * values, so most refills end in the first step. Mentors without capacity are skipped.
+ */
+static void load_window(const StableRun *run, int i) {
+    MenteePreferences *preferences = &run->preferences[i];
+    const int *row = run->compatibility_scores + (size_t)i * run->m;
+    int *window = run->windows + (size_t)i * PREFERENCE_CHUNK;
+    int count = 0;
+
+    // Step 1: Continue the run of mentors tied with the cursor
+    if (preferences->last_mentor != -1) {
+        for (int j = preferences->last_mentor + 1; j < run->m && count < PREFERENCE_CHUNK; j++) {
+            if (row[j] == preferences->last_score && run->capacities[j] > 0) {
+                window[count++] = j;
+            }
+        }
+    }
+
+    // Step 2: Fill the rest with the best mentors below the cursor's score
+    int tied = count;
+    for (int j = 0; j < run->m && tied < PREFERENCE_CHUNK; j++) {
+        if (run->capacities[j] <= 0) continue;
+
+        int score = row[j];
+        if (score >= preferences->last_score) continue;
+        if (count == PREFERENCE_CHUNK && score <= row[window[count - 1]]) continue;
+
+        // Equal scores keep ascending mentor order, so ties go to the lower index
+        int k = count < PREFERENCE_CHUNK ? count++ : PREFERENCE_CHUNK - 1;
+        while (k > tied && row[window[k - 1]] < score) {
+            window[k] = window[k - 1];
+            k--;
+        }
+        window[k] = j;
+    }
+
+    preferences->next = 0;
+    preferences->count = count;
+    preferences->exhausted = count < PREFERENCE_CHUNK;
+    if (count > 0) {
+        preferences->last_mentor = window[count - 1];
+        preferences->last_score = row[preferences->last_mentor];
+    }
+} // load_window
+
+/**
+ * @brief Packs a mentee and its score with a mentor into a ranking key.
+ *
+ * Keys order as the mentor ranks mentees: higher score first, then lower index.
+ * Every key is above `NO_THRESHOLD`.
+ */
+static inline unsigned long long mentee_key(int score, int mentee) {
+    return ((unsigned long long)(uint32_t)score << 32) | (uint32_t)~(uint32_t)mentee;
+} // mentee_key
+
+/**
+ * @brief Merges two skew heaps of held mentees, keeping the lowest key at the root.
+ *
+ * Top-down and iterative, so a long right spine cannot exhaust the stack.
+ *
+ * @return The root of the merged heap, or -1 if both are empty.
+ */
+static int merge_held(HeldMentee *held, int a, int b) {
+    int root = -1;
+    int *link = &root;
+    while (a != -1 && b != -1) {
+        if (held[b].key < held[a].key) {
+            int swap = a;
+            a = b;
+            b = swap;
+        }
+        *link = a;
+
+        // Merge into the right subtree, which then becomes the left one
+        int right = held[a].right;
+        held[a].right = held[a].left;
+        link = &held[a].left;
+        a = right;
+    }
+    *link = a != -1 ? a : b;
+    return root;
+} // merge_held
+
+/**
+ * @brief Offers a mentee to a mentor, which keeps it if it has room or ranks it above its worst.
+ *
+ * @param accepted Set to whether the mentor now holds the mentee.
+ * @return The mentee the mentor let go to make room, or -1.
+ */
+static int offer(const StableRun *run, int j, int i, unsigned long long key, bool *accepted) {
+    MentorState *mentor = &run->mentors[j];
+    *accepted = false;
+    if (key < atomic_load(&mentor->threshold)) return -1; // The threshold only rises, so this is final
+
+    int displaced = -1;
+    pthread_mutex_lock(&mentor->lock);
+    if (mentor->count == run->capacities[j] && key > run->held[mentor->root].key) {
+        displaced = mentor->root;
+        mentor->root = merge_held(run->held, run->held[displaced].left, run->held[displaced].right);
+        mentor->count--;
+        run->row_assigned[displaced] = -1;
+    }
+    if (mentor->count < run->capacities[j]) {
+        run->held[i] = (HeldMentee){.key = key, .left = -1, .right = -1};
+        mentor->root = merge_held(run->held, mentor->root, i);
+        run->row_assigned[i] = j;
+        *accepted = true;
+        if (++mentor->count == run->capacities[j]) atomic_store(&mentor->threshold, run->held[mentor->root].key);
+    }
+    pthread_mutex_unlock(&mentor->lock);
+    return displaced;
+} // offer
+
+/**
+ * @brief Lets a free mentee propose down its preferences until a mentor accepts it.
+ *
+ * The calling thread owns the mentee until a mentor holds it, so its progress needs
+ * no synchronization; only the mentors' state is shared.
+ *
+ * @return The mentee displaced by the accepting mentor, or -1 if the mentor had room
+ *         or the mentee has no mentors left to propose to.
+ */
+static int propose(const StableRun *run, int i) {
+    MenteePreferences *preferences = &run->preferences[i];
+    const int *window = run->windows + (size_t)i * PREFERENCE_CHUNK;
+
+    for (;;) {
+        if (preferences->next == preferences->count) {
+            if (preferences->exhausted) return -1;
+            load_window(run, i);
+            if (preferences->count == 0) return -1;
+        }
+
+        // If displaced later, the mentee resumes at the following mentor
+        int j = window[preferences->next++];
+        bool accepted;
+        int displaced = offer(run, j, i, mentee_key(run->compatibility_scores[(size_t)i * run->m + j], i), &accepted);
+        if (accepted) return displaced;
+    }
+} // propose
+
+/**
+ * @brief Pool task that builds the first preference window of a block of mentees.
+ */
+static void load_windows_task(void *arg, int task_index, int worker_index) {
+    (void)worker_index;
+    StableRun *run = arg;
+    int first = task_index * MENTEES_PER_TASK;
+    int last = first + MENTEES_PER_TASK < run->n ? first + MENTEES_PER_TASK : run->n;
+
+    for (int i = first; i < last; i++) {
+        run->preferences[i] = (MenteePreferences){.last_score = INT_MAX, .last_mentor = -1};
+        load_window(run, i);
+    }
+} // load_windows_task
+
+/**
+ * @brief Pool task that runs the proposals of a block of free mentees for one round.
+ */
+static void propose_task(void *arg, int task_index, int worker_index) {
+    (void)worker_index;
+    StableRun *run = arg;
+    int first = task_index * MENTEES_PER_TASK;
+    int last = first + MENTEES_PER_TASK < run->current_count ? first + MENTEES_PER_TASK : run->current_count;
+
+    for (int k = first; k < last; k++) {
+        if (is_cancelled(run->cancel)) return;
+        int displaced = propose(run, run->current[k]);
+        if (displaced != -1) run->next[atomic_fetch_add(&run->next_count, 1)] = displaced;
+    }
+} // propose_task
+
+/**
+ * @brief Computes the mentee-optimal stable matching with mentor capacities.
+ *
+ * Rounds run on the pool while enough mentees are free to share out; the last few
+ * displacement chains are followed on the calling thread. If `cancel` fires, the
+ * mentees still proposing stay unassigned, so the result is feasible but may not
+ * be stable.
+ *
+ * @param compatibility_scores Row-major `n x m` score matrix.
+ * @param n Number of mentees.
+ * @param m Number of mentors.
+ * @param capacities Capacity of each mentor.
+ * @param row_assigned Output array of `n` mentor indices (-1 when unmatched); written during the run.
+ * @param pool Worker pool that builds preferences and runs proposals.
+ * @param scratch Reusable scratch buffers.
+ * @param cancel Token that stops the proposals early (may be NULL).
+ * @return 1 on success, 0 on failure.
+ */
+int assign_stable_matching(const int *compatibility_scores, int n, int m, const int *capacities, int *row_assigned, ThreadPool *pool, StableScratch *scratch, CancellationToken *cancel) {
+    // Step 1: Start every mentor empty; its heap of held mentees is linked through `held`
+    if (!reserve_buffer((void **)&scratch->mentors, &scratch->mentors_capacity, m > 0 ? m : 1, sizeof(MentorState)) ||
+        !reserve_buffer((void **)&scratch->held, &scratch->held_capacity, n > 0 ? n : 1, sizeof(HeldMentee)) ||
+        !reserve_buffer((void **)&scratch->preferences, &scratch->preferences_capacity, n > 0 ? n : 1, sizeof(MenteePreferences)) ||
+        !reserve_buffer((void **)&scratch->windows, &scratch->windows_capacity,
+                        (size_t)(n > 0 ? n : 1) * PREFERENCE_CHUNK, sizeof(int)) ||
+        !reserve_buffer((void **)&scratch->free_mentees, &scratch->free_mentees_capacity,
+                        (size_t)(n > 0 ? n : 1) * 2, sizeof(int))) {
+        return 0;
+    }
+    for (int j = 0; j < m; j++) {
+        MentorState *mentor = &scratch->mentors[j];
+        init_mutex(&mentor->lock);
+        atomic_init(&mentor->threshold, NO_THRESHOLD);
+        mentor->root = -1;
+        mentor->count = 0;
+    }
+    for (int i = 0; i < n; i++) row_assigned[i] = -1;
+
+    StableRun run = {.compatibility_scores = compatibility_scores,
+                     .n = n,
+                     .m = m,
+                     .capacities = capacities,
+                     .mentors = scratch->mentors,
+                     .held = scratch->held,
+                     .row_assigned = row_assigned,
+                     .preferences = scratch->preferences,
+                     .windows = scratch->windows,
+                     .cancel = cancel};
+
+    // Step 2: Build the first preference window of every mentee in parallel
+    thread_pool_run(pool, load_windows_task, &run, (n + MENTEES_PER_TASK - 1) / MENTEES_PER_TASK);
+
+    // Step 3: Propose in parallel rounds while there is enough work to share
+    int *current = scratch->free_mentees;
+    int *next = scratch->free_mentees + n;
+    int count = n;
+    for (int i = 0; i < n; i++) current[i] = i;
+    while (count > MENTEES_PER_TASK && !is_cancelled(cancel)) {
+        run.current = current;
+        run.current_count = count;
+        run.next = next;
+        atomic_store(&run.next_count, 0);
+        thread_pool_run(pool, propose_task, &run, (count + MENTEES_PER_TASK - 1) / MENTEES_PER_TASK);
+
+        int *swap = current;
+        current = next;
+        next = swap;
+        count = atomic_load(&run.next_count);
+    }
+
+    // Step 4: Follow the remaining displacement chains on this thread
+    for (int k = 0; k < count; k++) {
+        for (int mentee = current[k]; mentee != -1 && !is_cancelled(cancel);) {
+            mentee = propose(&run, mentee);
+        }
+    }
+
+    for (int j = 0; j < m; j++) destroy_mutex(&scratch->mentors[j].lock);
+    return 1;
+} // assign_stable_matching
+
+/**
+ * @brief Frees the buffers held by a stable-matching scratch structure.
+ *
+ * @param scratch Pointer to the scratch structure.
+ */
+void free_stable_scratch(StableScratch *scratch) {
+    free(scratch->mentors);
+    free(scratch->held);
+    free(scratch->preferences);
+    free(scratch->windows);
+    free(scratch->free_mentees);
+    *scratch = (StableScratch){0};
+} // free_stable_scratch
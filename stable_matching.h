@@ -0,0 +1,87 @@
+/**
+ * @file stable_matching.h
+ * @brief Header file for the parallel capacitated stable-matching engine.
+ *
+ * Declares a hospitals/residents Gale-Shapley engine in which mentees propose to
+ * mentors. Both sides rank each other by compatibility score, with ties broken by
+ * the lower index, and each mentor accepts up to its capacity. The result is the
+ * mentee-optimal stable matching, which is unique, so it does not depend on the
+ * number of threads or the order in which proposals are processed.
+ *
+ * Dependencies:
+ * - `thread_pool.h`: Provides the worker pool that builds preferences and runs proposals.
+ * - `synchronization.h`: Defines the `CancellationToken` that bounds a run.
+ *
+ * Notes:
+ * - Every pair is acceptable, so the matching is as large as the total capacity allows.
+ * - Zero-initialize a `StableScratch` before first use and release it with `free_stable_scratch`.
+ */
+#ifndef STABLE_MATCHING_H
+#define STABLE_MATCHING_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "synchronization.h"
+#include "thread_pool.h"
+
+#define PREFERENCE_CHUNK 16 // Mentors held in a mentee's partially sorted preference window
+
+/**
+ * @brief Proposal progress of one mentee.
+ *
+ * Only the next `PREFERENCE_CHUNK` mentors of a mentee are kept sorted at a time.
+ * When the window is used up, the following mentors are selected after the cursor
+ * (`last_score`, `last_mentor`), the last mentor loaded into it.
+ */
+typedef struct {
+    int next;         ///< Position in the window of the next mentor to propose to
+    int count;        ///< Number of mentors in the window
+    int last_score;   ///< Score of the last mentor loaded into the window
+    int last_mentor;  ///< Index of the last mentor loaded into the window
+    bool exhausted;   ///< No mentors are left beyond the window
+} MenteePreferences;
+
+/**
+ * @brief Proposal state of one mentor, shared by the proposing threads.
+ */
+typedef struct {
+    pthread_mutex_t lock;         ///< Guards `root` and `count`
+    atomic_ullong threshold;      ///< Key of the worst held mentee once full, which every proposal must beat
+    int root;                     ///< Held mentee with the lowest key, or -1
+    int count;                    ///< Number of held mentees
+} MentorState;
+
+/**
+ * @brief A mentee held by a mentor, as a node of that mentor's skew heap.
+ */
+typedef struct {
+    unsigned long long key;       ///< Score with the holding mentor and index, packed in ranking order
+    int left;                     ///< Children in the heap, or -1
+    int right;
+} HeldMentee;
+
+/**
+ * @brief Reusable scratch space for the stable-matching engine.
+ *
+ * Buffers only grow, so repeated runs on inputs of similar size do not allocate.
+ */
+typedef struct {
+    MentorState *mentors;            ///< Proposal state of each mentor
+    size_t mentors_capacity;
+    HeldMentee *held;                ///< Heap node of each mentee while a mentor holds it
+    size_t held_capacity;
+    MenteePreferences *preferences;  ///< Proposal progress of each mentee
+    size_t preferences_capacity;
+    int *windows;                    ///< `PREFERENCE_CHUNK` mentors per mentee, best first
+    size_t windows_capacity;
+    int *free_mentees;               ///< Mentees proposing in the current and the next round
+    size_t free_mentees_capacity;
+} StableScratch;
+
+// Function Declarations
+int assign_stable_matching(const int *compatibility_scores, int n, int m, const int *capacities, int *row_assigned, ThreadPool *pool, StableScratch *scratch, CancellationToken *cancel);
+void free_stable_scratch(StableScratch *scratch);
+
+#endif // STABLE_MATCHING_H
@@ -0,0 +1,578 @@
+/**
+ * @file stream_matcher.c
+ * @brief Online assignment of mentees read from a stream.
+ *
+ * The mentors are indexed once: their attributes are interned and every attribute
+ * id lists the mentors that carry it (an inverted index). A mentee is then scored
+ * by walking the lists of its own attributes, which touches only the mentors it
+ * shares an attribute with instead of the whole mentor set; every other mentor
+ * scores 0. Mentees are scored in micro-batches on a worker pool and assigned in
+ * arrival order on the calling thread, which owns the remaining capacities.
+ *
+ * The stream reader takes whatever input is available on each read, so a busy
+ * feed is processed in batches of up to `STREAM_BATCH_ROWS` mentees while a slow
+ * one is answered line by line. Matches are flushed after every batch.
+ *
+ * Dependencies:
+ * - `stream_matcher.h`: Declares the interface for this functionality.
+ * - `attribute_dictionary.h`: Interns the mentors' attribute strings.
+ * - `attribute_weights.h`: Provides the weights of the mentors' attributes.
+ * - `thread_pool.h`: Provides the worker pool that scores each batch.
+ */
+#include "stream_matcher.h"
+#include "attribute_dictionary.h"
+#include "attribute_weights.h"
+#include "thread_pool.h"
+#include <errno.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define STREAM_ROWS_PER_TASK 16   // Mentees of a batch scored by one pool task
+#define STREAM_READ_SIZE 65536    // Bytes requested from the input per read
+#define STREAM_POLL_MS 10         // Interval at which a waiting reader checks for cancellation
+#define LATENCY_SUB_BUCKETS 32    // Linear sub-buckets per power of two of nanoseconds
+#define LATENCY_BUCKETS (2 * LATENCY_SUB_BUCKETS + 58 * LATENCY_SUB_BUCKETS)
+
+struct StreamMatcher {
+    ThreadPool *pool;
+    const DataSet *mentors;
+    AttributeDictionary dictionary;  // Attributes of the mentors only
+    int *posting_starts;             // Mentors of attribute id `a` are postings[posting_starts[a]..posting_starts[a + 1])
+    int *postings;                   // One entry per attribute occurrence, so repeated attributes count twice
+    int *weights;                    // Weight of each attribute id, or NULL to count shared attributes
+    int *capacity_remaining;         // Remaining capacity of each mentor
+    int first_open;                  // No mentor below this index has capacity left
+    int *accumulators;               // One zeroed row of partial scores per worker
+    int *candidates;                 // Mentors sharing an attribute with each mentee of the batch
+    int *candidate_scores;           // Scores of those mentors
+    size_t candidate_capacity;       // Entries `candidates` and `candidate_scores` can hold
+    int *candidate_counts;           // Number of candidates of each mentee of the batch
+};
+
+/**
+ * @brief Arguments shared by every scoring task of a batch.
+ */
+typedef struct {
+    StreamMatcher *matcher;
+    const DataRow *mentees;
+    int count;
+} StreamBatch;
+
+/**
+ * @brief Latency histogram with logarithmic buckets of linear sub-buckets.
+ *
+ * Values below `2 * LATENCY_SUB_BUCKETS` ns are exact; above that each power of two
+ * is split into `LATENCY_SUB_BUCKETS` buckets, so a bucket spans at most 1/32 of its value.
+ */
+typedef struct {
+    long counts[LATENCY_BUCKETS];
+    long total;
+    uint64_t max;
+} LatencyHistogram;
+
+/**
+ * @brief Returns the histogram bucket of a latency in nanoseconds.
+ */
+static int latency_bucket(uint64_t nanoseconds) {
+    if (nanoseconds < 2 * LATENCY_SUB_BUCKETS) return (int)nanoseconds;
+    int exponent = 63 - __builtin_clzll(nanoseconds);
+    int shift = exponent - 5;
+    int sub_bucket = (int)(nanoseconds >> shift) - LATENCY_SUB_BUCKETS;
+    return 2 * LATENCY_SUB_BUCKETS + (exponent - 6) * LATENCY_SUB_BUCKETS + sub_bucket;
+} // latency_bucket
+
+/**
+ * @brief Returns the highest latency, in nanoseconds, that falls into a bucket.
+ */
+static uint64_t latency_bucket_limit(int bucket) {
+    if (bucket < 2 * LATENCY_SUB_BUCKETS) return (uint64_t)bucket;
+    int exponent = (bucket - 2 * LATENCY_SUB_BUCKETS) / LATENCY_SUB_BUCKETS + 6;
+    uint64_t sub_bucket = (uint64_t)((bucket - 2 * LATENCY_SUB_BUCKETS) % LATENCY_SUB_BUCKETS) + LATENCY_SUB_BUCKETS;
+    return ((sub_bucket + 1) << (exponent - 5)) - 1;
+} // latency_bucket_limit
+
+/**
+ * @brief Returns a latency percentile in milliseconds.
+ *
+ * @param histogram Pointer to the histogram.
+ * @param fraction Percentile as a fraction (e.g., 0.99).
+ */
+static double latency_percentile(const LatencyHistogram *histogram, double fraction) {
+    if (histogram->total == 0) return 0.0;
+    long target = (long)(fraction * histogram->total);
+    if (target < 1) target = 1;
+
+    long seen = 0;
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        seen += histogram->counts[b];
+        if (seen >= target) {
+            uint64_t limit = latency_bucket_limit(b);
+            return (limit < histogram->max ? limit : histogram->max) / 1e6;
+        }
+    }
+    return histogram->max / 1e6;
+} // latency_percentile
+
+/**
+ * @brief Returns the nanoseconds elapsed between two monotonic timestamps.
+ */
+static uint64_t elapsed_ns(const struct timespec *start, const struct timespec *end) {
+    return (uint64_t)(end->tv_sec - start->tv_sec) * 1000000000ULL + (uint64_t)end->tv_nsec - (uint64_t)start->tv_nsec;
+} // elapsed_ns
+
+/**
+ * @brief Creates a matcher over a fixed set of mentors.
+ *
+ * Interns the mentors' attributes and builds the inverted index from attribute id
+ * to mentors. Mentee attributes that no mentor has are ignored when scoring, so
+ * the index does not grow with the stream. The weights, if any, are looked up
+ * once per mentor attribute here.
+ *
+ * @param mentors Pointer to the dataset of mentors, with their capacities.
+ * @param weights Attribute weights, or NULL to count shared attributes.
+ * @param num_threads Number of worker threads, or 0 to use one per online CPU.
+ * @return Pointer to the matcher, or NULL on failure.
+ */
+StreamMatcher *stream_matcher_create(const DataSet *mentors, const AttributeWeights *weights, int num_threads) {
+    if (!mentors) {
+        fprintf(stderr, "Invalid inputs to stream_matcher_create.\n");
+        return NULL;
+    }
+    if (num_threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = cpus > 0 ? (int)cpus : 1;
+    }
+
+    StreamMatcher *matcher = calloc(1, sizeof(StreamMatcher));
+    if (!matcher) {
+        perror("Failed to allocate memory for stream matcher");
+        return NULL;
+    }
+    matcher->mentors = mentors;
+    init_attribute_dictionary(&matcher->dictionary);
+
+    // Step 1: Intern every mentor attribute and count its occurrences
+    int m = mentors->row_count;
+    size_t occurrences = 0;
+    for (int j = 0; j < m; j++) {
+        for (int a = 0; a < mentors->rows[j].attributes_count; a++) {
+            if (intern_attribute(&matcher->dictionary, mentors->rows[j].attributes[a]) == -1) {
+                stream_matcher_destroy(matcher);
+                return NULL;
+            }
+            occurrences++;
+        }
+    }
+
+    int ids = matcher->dictionary.count;
+    size_t row_cells = (size_t)(m > 0 ? m : 1);
+    matcher->posting_starts = calloc((size_t)ids + 1, sizeof(int));
+    matcher->postings = malloc((occurrences > 0 ? occurrences : 1) * sizeof(int));
+    matcher->capacity_remaining = malloc(row_cells * sizeof(int));
+    matcher->accumulators = calloc((size_t)num_threads * row_cells, sizeof(int));
+    matcher->candidate_counts = malloc(STREAM_BATCH_ROWS * sizeof(int));
+    matcher->pool = thread_pool_create(num_threads);
+    if (!matcher->posting_starts || !matcher->postings || !matcher->capacity_remaining || !matcher->accumulators ||
+        !matcher->candidate_counts || !matcher->pool) {
+        perror("Failed to allocate memory for stream matcher");
+        stream_matcher_destroy(matcher);
+        return NULL;
+    }
+
+    // Step 2: Lay out the postings of each attribute and list the mentors in index order
+    for (int j = 0; j < m; j++) {
+        for (int a = 0; a < mentors->rows[j].attributes_count; a++) {
+            matcher->posting_starts[find_attribute(&matcher->dictionary, mentors->rows[j].attributes[a]) + 1]++;
+        }
+    }
+    for (int id = 0; id < ids; id++) matcher->posting_starts[id + 1] += matcher->posting_starts[id];
+    for (int j = 0; j < m; j++) {
+        for (int a = 0; a < mentors->rows[j].attributes_count; a++) {
+            int id = find_attribute(&matcher->dictionary, mentors->rows[j].attributes[a]);
+            matcher->postings[matcher->posting_starts[id]++] = j;
+        }
+    }
+    for (int id = ids; id > 0; id--) matcher->posting_starts[id] = matcher->posting_starts[id - 1];
+    matcher->posting_starts[0] = 0;
+
+    if (weights) {
+        matcher->weights = malloc((ids > 0 ? ids : 1) * sizeof(int));
+        if (!matcher->weights) {
+            perror("Failed to allocate memory for stream matcher");
+            stream_matcher_destroy(matcher);
+            return NULL;
+        }
+        for (int id = 0; id < ids; id++) matcher->weights[id] = attribute_weight(weights, attribute_name(&matcher->dictionary, id));
+    }
+
+    for (int j = 0; j < m; j++) matcher->capacity_remaining[j] = mentors->rows[j].capacity;
+    return matcher;
+} // stream_matcher_create
+
+/**
+ * @brief Destroys a matcher, stopping its threads and freeing its buffers.
+ *
+ * @param matcher Pointer to the matcher (may be NULL).
+ */
+void stream_matcher_destroy(StreamMatcher *matcher) {
+    if (!matcher) return;
+
+    if (matcher->pool) thread_pool_destroy(matcher->pool);
+    free_attribute_dictionary(&matcher->dictionary);
+    free(matcher->posting_starts);
+    free(matcher->postings);
+    free(matcher->weights);
+    free(matcher->capacity_remaining);
+    free(matcher->accumulators);
+    free(matcher->candidates);
+    free(matcher->candidate_scores);
+    free(matcher->candidate_counts);
+    free(matcher);
+} // stream_matcher_destroy
+
+/**
+ * @brief Pool task that finds the candidate mentors of a block of mentees.
+ *
+ * Scores accumulate in the worker's own row, which is cleared again through the
+ * candidate list, so the cost is proportional to the postings walked. Attributes
+ * weighted 0 are skipped, so every candidate has a positive score.
+ */
+static void score_stream_task(void *arg, int task_index, int worker_index) {
+    StreamBatch *batch = arg;
+    StreamMatcher *matcher = batch->matcher;
+    int m = matcher->mentors->row_count;
+    int *accumulator = matcher->accumulators + (size_t)worker_index * m;
+    int first = task_index * STREAM_ROWS_PER_TASK;
+    int last = first + STREAM_ROWS_PER_TASK < batch->count ? first + STREAM_ROWS_PER_TASK : batch->count;
+
+    for (int i = first; i < last; i++) {
+        int *candidates = matcher->candidates + (size_t)i * m;
+        int *scores = matcher->candidate_scores + (size_t)i * m;
+        int count = 0;
+
+        const DataRow *mentee = &batch->mentees[i];
+        for (int a = 0; a < mentee->attributes_count; a++) {
+            int id = find_attribute(&matcher->dictionary, mentee->attributes[a]);
+            int weight = id == -1 ? 0 : matcher->weights ? matcher->weights[id] : 1;
+            if (weight == 0) continue;
+            for (int p = matcher->posting_starts[id]; p < matcher->posting_starts[id + 1]; p++) {
+                int j = matcher->postings[p];
+                if (accumulator[j] == 0) candidates[count++] = j;
+                accumulator[j] += weight;
+            }
+        }
+
+        for (int k = 0; k < count; k++) {
+            scores[k] = accumulator[candidates[k]];
+            accumulator[candidates[k]] = 0;
+        }
+        matcher->candidate_counts[i] = count;
+    }
+} // score_stream_task
+
+/**
+ * @brief Picks the best mentor with remaining capacity from a mentee's candidates.
+ *
+ * Matches `select_best_mentor` on the full score row: the highest score wins, ties
+ * go to the lower index, and a mentee without a candidate left takes the first
+ * mentor that still has capacity, at score 0.
+ *
+ * @return Index of the selected mentor, or -1 if every mentor is full.
+ */
+static int select_streamed_mentor(StreamMatcher *matcher, const int *candidates, const int *scores, int count, int *score) {
+    int best = -1;
+    *score = 0;
+    for (int k = 0; k < count; k++) {
+        int j = candidates[k];
+        if (matcher->capacity_remaining[j] <= 0) continue;
+        if (best == -1 || scores[k] > *score || (scores[k] == *score && j < best)) {
+            best = j;
+            *score = scores[k];
+        }
+    }
+    if (best != -1) return best;
+
+    int m = matcher->mentors->row_count;
+    while (matcher->first_open < m && matcher->capacity_remaining[matcher->first_open] <= 0) matcher->first_open++;
+    return matcher->first_open < m ? matcher->first_open : -1;
+} // select_streamed_mentor
+
+/**
+ * @brief Grows the candidate buffers so a batch of `count` mentees fits.
+ *
+ * Each mentee may share an attribute with every mentor, so a batch needs `count * m`
+ * entries. The buffers follow the largest batch seen instead of a full
+ * `STREAM_BATCH_ROWS`, so a feed answered line by line keeps them one row long.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+static int reserve_candidates(StreamMatcher *matcher, int count) {
+    int m = matcher->mentors->row_count;
+    size_t needed = (size_t)count * (m > 0 ? m : 1);
+    if (needed <= matcher->candidate_capacity) return 1;
+
+    size_t capacity = matcher->candidate_capacity ? matcher->candidate_capacity : 64;
+    while (capacity < needed) capacity *= 2;
+    int *candidates = realloc(matcher->candidates, capacity * sizeof(int));
+    if (candidates) matcher->candidates = candidates;
+    int *scores = candidates ? realloc(matcher->candidate_scores, capacity * sizeof(int)) : NULL;
+    if (!scores) {
+        perror("Failed to allocate memory for stream matcher");
+        return 0;
+    }
+    matcher->candidate_scores = scores;
+    matcher->candidate_capacity = capacity;
+    return 1;
+} // reserve_candidates
+
+/**
+ * @brief Assigns mentees, in order, to the best mentors with remaining capacity.
+ *
+ * Capacities carry over between calls, so consecutive calls continue the same
+ * online assignment.
+ *
+ * @param matcher Pointer to the matcher.
+ * @param mentees Mentees to assign, in arrival order.
+ * @param count Number of mentees.
+ * @param matches Caller buffer of `count` mentor indices (-1 when unmatched).
+ * @param match_scores Optional caller buffer of `count` scores of the assigned pairs (may be NULL).
+ * @return 1 on success, 0 on failure.
+ */
+int stream_matcher_assign(StreamMatcher *matcher, const DataRow *mentees, int count, int *matches, int *match_scores) {
+    if (!matcher || (count > 0 && (!mentees || !matches))) {
+        fprintf(stderr, "Invalid inputs to stream_matcher_assign.\n");
+        return 0;
+    }
+
+    int m = matcher->mentors->row_count;
+    for (int first = 0; first < count; first += STREAM_BATCH_ROWS) {
+        StreamBatch batch = {.matcher = matcher,
+                             .mentees = mentees + first,
+                             .count = count - first < STREAM_BATCH_ROWS ? count - first : STREAM_BATCH_ROWS};
+        if (!reserve_candidates(matcher, batch.count)) return 0;
+        thread_pool_run(matcher->pool, score_stream_task, &batch,
+                        (batch.count + STREAM_ROWS_PER_TASK - 1) / STREAM_ROWS_PER_TASK);
+
+        for (int i = 0; i < batch.count; i++) {
+            int score;
+            int best = select_streamed_mentor(matcher, matcher->candidates + (size_t)i * m,
+                                              matcher->candidate_scores + (size_t)i * m,
+                                              matcher->candidate_counts[i], &score);
+            if (best != -1) matcher->capacity_remaining[best]--;
+            matches[first + i] = best;
+            if (match_scores) match_scores[first + i] = best != -1 ? score : 0;
+        }
+    }
+    return 1;
+} // stream_matcher_assign
+
+/**
+ * @brief Assigns a batch of parsed mentees, writes their matches and records their latency.
+ *
+ * Each row adds one latency sample, from its own arrival to the flush of the batch.
+ *
+ * @return 1 on success, 0 on failure. The rows are freed either way.
+ */
+static int flush_stream_batch(StreamMatcher *matcher, DataRow *rows, int count, FILE *out, const struct timespec *arrivals,
+                              struct timespec *written, LatencyHistogram *histogram, StreamReport *report) {
+    int matches[STREAM_BATCH_ROWS];
+    int scores[STREAM_BATCH_ROWS];
+    int assigned = stream_matcher_assign(matcher, rows, count, matches, scores);
+
+    for (int i = 0; assigned && i < count; i++) {
+        if (matches[i] != -1) {
+            fprintf(out, "%s,%s,%d\n", rows[i].name, matcher->mentors->rows[matches[i]].name, scores[i]);
+            report->assigned++;
+            report->total_score += scores[i];
+        } else {
+            fprintf(out, "%s,No Match,0\n", rows[i].name);
+        }
+    }
+    fflush(out);
+
+    clock_gettime(CLOCK_MONOTONIC, written);
+    for (int i = 0; i < count; i++) free_data_row(&rows[i]);
+    if (!assigned) return 0;
+
+    for (int i = 0; i < count; i++) {
+        uint64_t latency = elapsed_ns(&arrivals[i], written);
+        histogram->counts[latency_bucket(latency)]++;
+        if (latency > histogram->max) histogram->max = latency;
+    }
+    histogram->total += count;
+    report->rows += count;
+    return 1;
+} // flush_stream_batch
+
+/**
+ * @brief Waits until the input is readable or `cancel` fires.
+ *
+ * @return 1 if the input is readable, 0 if cancelled, -1 on error.
+ */
+static int wait_for_input(int fd, CancellationToken *cancel) {
+    struct pollfd descriptor = {.fd = fd, .events = POLLIN};
+    for (;;) {
+        if (is_cancelled(cancel)) return 0;
+        int ready = poll(&descriptor, 1, STREAM_POLL_MS);
+        if (ready > 0) return 1;
+        if (ready < 0 && errno != EINTR) {
+            perror("Failed to wait for streamed input");
+            return -1;
+        }
+    }
+} // wait_for_input
+
+/**
+ * @brief Reads mentees from a stream and writes their matches as they arrive.
+ *
+ * The input uses the format of the mentee CSV file, header line included. Each
+ * read is split into lines, which are parsed, matched and written in batches of
+ * up to `STREAM_BATCH_ROWS`; blank lines are skipped. The output has the format
+ * of `output.csv` and is flushed after every batch. A row arrives with the read
+ * that delivers the end of its line. Lines longer than `MAX_LINE_LENGTH - 4` bytes
+ * are rejected as soon as that many bytes have arrived without a newline: the rows
+ * before them are still matched, and then the stream fails.
+ *
+ * At end of input the stream ends, unless `follow` is set, in which case the input
+ * is polled for new data, as for a file that is still being written. Either way
+ * the stream also ends once `cancel` fires.
+ *
+ * @param matcher Pointer to the matcher.
+ * @param fd Input file descriptor (e.g., `STDIN_FILENO`).
+ * @param follow Keep reading past the end of the input until cancelled.
+ * @param out Output stream for the matches.
+ * @param cancel Token that ends the stream (may be NULL).
+ * @param report Pointer to the report to be filled in.
+ * @return 1 on success, 0 on failure.
+ */
+int stream_mentees(StreamMatcher *matcher, int fd, bool follow, FILE *out, CancellationToken *cancel, StreamReport *report) {
+    *report = (StreamReport){0};
+    LatencyHistogram *histogram = calloc(1, sizeof(LatencyHistogram));
+    size_t capacity = STREAM_READ_SIZE;
+    char *buffer = malloc(capacity);
+    if (!histogram || !buffer) {
+        perror("Failed to allocate memory for streamed input");
+        free(histogram);
+        free(buffer);
+        return 0;
+    }
+
+    fprintf(out, "Mentee,Mentor,Compatibility Score\n");
+    fflush(out);
+
+    struct timespec poll_interval = {.tv_sec = 0, .tv_nsec = STREAM_POLL_MS * 1000000L};
+    struct timespec first_arrival = {0};
+    struct timespec last_output = {0};
+    DataRow rows[STREAM_BATCH_ROWS];
+    struct timespec arrivals[STREAM_BATCH_ROWS];
+    long line_number = 0;
+    size_t length = 0;
+    bool header_pending = true;
+    bool at_end = false;
+    int ok = 1;
+
+    while (ok && !at_end) {
+        // Step 1: Wait for input and append whatever is available
+        int ready = wait_for_input(fd, cancel);
+        if (ready <= 0) {
+            ok = ready == 0;
+            break;
+        }
+        if (capacity - length < STREAM_READ_SIZE / 2) {
+            char *grown = realloc(buffer, capacity * 2);
+            if (!grown) {
+                perror("Failed to allocate memory for streamed input");
+                ok = 0;
+                break;
+            }
+            buffer = grown;
+            capacity *= 2;
+        }
+        ssize_t received = read(fd, buffer + length, capacity - length);
+        if (received < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            perror("Failed to read streamed input");
+            ok = 0;
+            break;
+        }
+        if (received == 0) {
+            if (follow) {
+                nanosleep(&poll_interval, NULL);
+                continue;
+            }
+            at_end = true; // A last line without a newline still counts
+        }
+        length += received;
+
+        struct timespec arrival;
+        clock_gettime(CLOCK_MONOTONIC, &arrival);
+
+        // Step 2: Parse the complete lines and match them in batches
+        size_t start = 0;
+        int count = 0;
+        bool rejected = false;
+        while (ok && start < length) {
+            char *newline = memchr(buffer + start, '\n', length - start);
+            size_t end = newline ? (size_t)(newline - buffer) : length;
+
+            // A line still waiting for its newline is rejected as soon as it is too long, so
+            // the buffer never holds more than one line, even when following the input
+            if (!newline && !at_end && end - start <= MAX_LINE_LENGTH - 4) break;
+            line_number++;
+
+            // parse_csv_row may look a few bytes past the end of a token
+            if (end - start > MAX_LINE_LENGTH - 4) {
+                fprintf(stderr, "Error: Line %ld of the streamed input is longer than %d bytes.\n",
+                        line_number, MAX_LINE_LENGTH - 4);
+                rejected = true;
+                break;
+            }
+            char line[MAX_LINE_LENGTH] = {0};
+            memcpy(line, buffer + start, end - start);
+            start = newline ? end + 1 : length;
+
+            // Blank lines before the header do not stand in for it
+            if (line[strspn(line, " \t\r")] == '\0') continue;
+            if (header_pending) {
+                header_pending = false;
+                continue;
+            }
+            if (!parse_csv_row(line, &rows[count])) {
+                free_data_row(&rows[count]);
+                ok = 0;
+                break;
+            }
+            arrivals[count] = arrival;
+            if (report->rows == 0 && count == 0) first_arrival = arrival;
+            if (++count == STREAM_BATCH_ROWS) {
+                ok = flush_stream_batch(matcher, rows, count, out, arrivals, &last_output, histogram, report);
+                count = 0;
+            }
+        }
+        if (count > 0 && ok) {
+            ok = flush_stream_batch(matcher, rows, count, out, arrivals, &last_output, histogram, report);
+        } else {
+            for (int i = 0; i < count; i++) free_data_row(&rows[i]);
+        }
+        if (rejected) ok = 0;
+
+        memmove(buffer, buffer + start, length - start);
+        length -= start;
+    }
+
+    // Step 3: Summarize throughput and latency
+    if (report->rows > 0) {
+        report->seconds = elapsed_ns(&first_arrival, &last_output) / 1e9;
+        report->rows_per_second = report->seconds > 0 ? report->rows / report->seconds : 0.0;
+        report->p50_latency_ms = latency_percentile(histogram, 0.50);
+        report->p99_latency_ms = latency_percentile(histogram, 0.99);
+        report->max_latency_ms = histogram->max / 1e6;
+    }
+    free(histogram);
+    free(buffer);
+    return ok;
+} // stream_mentees
@@ -0,0 +1,60 @@
+/**
+ * @file stream_matcher.h
+ * @brief Header file for the online matcher of streamed mentees.
+ *
+ * Declares a matcher that indexes the mentors once and then assigns mentees as
+ * they arrive, in arrival order, each to its best mentor with remaining capacity.
+ * This is the assignment `select_optimal_matches` makes for the same mentees in
+ * the same order, so a stream yields the same matches as a batch run on the
+ * collected input.
+ *
+ * Dependencies:
+ * - `attribute_weights.h`: Defines the `AttributeWeights` applied while scoring.
+ * - `input_parser.h`: Defines the `DataSet` and `DataRow` structures used for input data.
+ * - `synchronization.h`: Defines the `CancellationToken` that ends a stream.
+ *
+ * Notes:
+ * - The mentors must outlive the matcher; the weights are only read while creating it.
+ * - A matcher must not be used by more than one thread at a time.
+ */
+#ifndef STREAM_MATCHER_H
+#define STREAM_MATCHER_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "attribute_weights.h"
+#include "input_parser.h"
+#include "synchronization.h"
+
+#define STREAM_BATCH_ROWS 256 // Mentees scored together before their matches are written
+
+/**
+ * @brief Opaque handle to an online matcher.
+ */
+typedef struct StreamMatcher StreamMatcher;
+
+/**
+ * @brief Summary of a streaming run.
+ *
+ * Throughput is measured from the arrival of the first mentee to the output of
+ * the last one. Latency runs from the read that delivered a mentee to the flush
+ * of its match, and percentiles are accurate to about 3%.
+ */
+typedef struct {
+    long rows;                ///< Mentees read and matched
+    long assigned;            ///< Mentees that received a mentor
+    long total_score;         ///< Sum of the scores of the assigned pairs
+    double seconds;           ///< Time from the first arrival to the last output
+    double rows_per_second;   ///< Throughput over `seconds`
+    double p50_latency_ms;    ///< Median latency per mentee
+    double p99_latency_ms;    ///< 99th percentile latency per mentee
+    double max_latency_ms;    ///< Highest latency per mentee
+} StreamReport;
+
+// Function Declarations
+StreamMatcher *stream_matcher_create(const DataSet *mentors, const AttributeWeights *weights, int num_threads);
+void stream_matcher_destroy(StreamMatcher *matcher);
+int stream_matcher_assign(StreamMatcher *matcher, const DataRow *mentees, int count, int *matches, int *match_scores);
+int stream_mentees(StreamMatcher *matcher, int fd, bool follow, FILE *out, CancellationToken *cancel, StreamReport *report);
+
+#endif // STREAM_MATCHER_H
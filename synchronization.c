@@ -3,7 +3,8 @@
  * @brief Provides utilities for managing thread synchronization primitives.
  *
  * Implements helper functions to initialize and destroy mutexes,
- * ensuring thread-safe operations in multi-threaded applications.
+ * ensuring thread-safe operations in multi-threaded applications, and a
+ * cancellation token used to bound the running time of scoring and solving.
  *
  * Dependencies:
  * - `synchronization.h`: Declares the interface for these utilities.
@@ -43,4 +44,61 @@ void destroy_mutex(pthread_mutex_t *mutex) {
     if (pthread_mutex_destroy(mutex) != 0) {
         perror("Failed to destroy mutex");
     }
-} // destroy_mutex
\ No newline at end of file
+} // destroy_mutex
+
+/**
+ * @brief Initializes a cancellation token that is not cancelled and has no deadline.
+ *
+ * @param token Pointer to the token to be initialized.
+ */
+void init_cancellation_token(CancellationToken *token) {
+    atomic_init(&token->cancelled, false);
+    token->has_deadline = false;
+} // init_cancellation_token
+
+/**
+ * @brief Arms the token to cancel itself `deadline_ms` milliseconds from now.
+ *
+ * @param token Pointer to the token.
+ * @param deadline_ms Time budget in milliseconds.
+ */
+void set_cancellation_deadline(CancellationToken *token, long deadline_ms) {
+    clock_gettime(CLOCK_MONOTONIC, &token->deadline);
+    token->deadline.tv_sec += deadline_ms / 1000;
+    token->deadline.tv_nsec += (deadline_ms % 1000) * 1000000L;
+    if (token->deadline.tv_nsec >= 1000000000L) {
+        token->deadline.tv_sec++;
+        token->deadline.tv_nsec -= 1000000000L;
+    }
+    token->has_deadline = true;
+} // set_cancellation_deadline
+
+/**
+ * @brief Cancels the token immediately.
+ *
+ * @param token Pointer to the token.
+ */
+void request_cancellation(CancellationToken *token) {
+    atomic_store(&token->cancelled, true);
+} // request_cancellation
+
+/**
+ * @brief Reports whether work guarded by the token should stop.
+ *
+ * @param token Pointer to the token (NULL is never cancelled).
+ * @return true if cancellation was requested or the deadline has passed.
+ */
+bool is_cancelled(CancellationToken *token) {
+    if (!token) return false;
+    if (atomic_load_explicit(&token->cancelled, memory_order_relaxed)) return true;
+    if (!token->has_deadline) return false;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (now.tv_sec > token->deadline.tv_sec ||
+        (now.tv_sec == token->deadline.tv_sec && now.tv_nsec >= token->deadline.tv_nsec)) {
+        atomic_store(&token->cancelled, true);
+        return true;
+    }
+    return false;
+} // is_cancelled
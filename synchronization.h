@@ -2,7 +2,8 @@
  * @file synchronization.h
  * @brief Header file for thread synchronization utilities.
  *
- * Declares functions for managing mutexes in multi-threaded applications.
+ * Declares functions for managing mutexes in multi-threaded applications, and a
+ * cancellation token that lets long-running phases stop cooperatively.
  *
  * Dependencies:
  * - `pthread.h`: Provides the POSIX threading API for working with mutexes.
@@ -11,14 +12,31 @@
  * - The caller is responsible for declaring and allocating the mutex.
  * - Mutexes must be destroyed after use to avoid resource leaks.
  * - Ensure no threads are using the mutex before calling `destroy_mutex`.
+ * - A cancellation token may be polled from any thread; once cancelled it stays cancelled.
  */
 #ifndef SYNCHRONIZATION_H
 #define SYNCHRONIZATION_H
 
 #include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <time.h>
+
+/**
+ * @brief Cooperative cancellation flag with an optional deadline.
+ */
+typedef struct {
+    atomic_bool cancelled;     ///< Set by `request_cancellation` or once the deadline passes
+    bool has_deadline;         ///< Whether `deadline` is in effect
+    struct timespec deadline;  ///< Absolute `CLOCK_MONOTONIC` deadline
+} CancellationToken;
 
 // Declare Functions
 void init_mutex(pthread_mutex_t *mutex);
 void destroy_mutex(pthread_mutex_t *mutex);
+void init_cancellation_token(CancellationToken *token);
+void set_cancellation_deadline(CancellationToken *token, long deadline_ms);
+void request_cancellation(CancellationToken *token);
+bool is_cancelled(CancellationToken *token);
 
 #endif
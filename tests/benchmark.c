@@ -0,0 +1,526 @@
+/**
+ * @file benchmark.c
+ * @brief Benchmark workloads with a regression gate against a stored baseline.
+ *
+ * Generates deterministic workloads, times every pipeline phase (parsing, each
+ * scoring engine, each assignment engine, output writing, online stream
+ * matching and IDF-weighted scoring) and reports the median of several repetitions, plus the throughput of
+ * each assignment engine and of the stream matcher. Every repetition also times a fixed reference
+ * workload that does not use the pairing code. With `--baseline`, the run fails if any phase, measured
+ * relative to the reference, is slower than its baseline by more than the given tolerance, so a machine
+ * that is slower or busier as a whole does not fail the gate. Weighted scoring is measured relative to
+ * unweighted scoring instead, which runs the same threads over the same data right before it. Short
+ * phases are repeated within each sample, so timer noise stays small next to every measured time. Phases
+ * that look slower are measured a second time before the run fails, and a baseline that does not list
+ * exactly the measured phases fails it too. `--write-baseline` records the current timings instead.
+ *
+ * Usage:
+ *   benchmark [--baseline <file> [--tolerance <percent>]] [--write-baseline <file>]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "attribute_weights.h"
+#include "matching_engine.h"
+#include "output_writer.h"
+#include "pairing.h"
+#include "process_sharding.h"
+#include "solution_selector.h"
+#include "stable_matching.h"
+#include "stream_matcher.h"
+#include "test_utils.h"
+#include "thread_pool.h"
+
+#define REPEATS 9                 // Repetitions per phase; the median is reported
+#define DEFAULT_TOLERANCE 25.0    // Allowed slowdown in percent
+#define MIN_SAMPLE_SECONDS 0.005  // Short phases repeat until one sample spans this long
+#define MAX_PHASES 64
+#define PHASE_COUNT 11            // Timed phases per workload, the reference included
+#define REFERENCE_WORDS (1 << 18) // Size of the reference workload's buffer
+
+/**
+ * @brief Phases gated against another phase of their workload instead of the reference.
+ */
+static const char *const RELATIVE_PHASES[][2] = {
+    {"score_weighted", "score_context"}, // Same pool and inputs, so only the kernels differ
+};
+
+/**
+ * @brief Size of a generated workload.
+ */
+typedef struct {
+    const char *name;
+    int mentees;
+    int mentors;
+} Workload;
+
+/**
+ * @brief Median time measured for one phase of one workload.
+ */
+typedef struct {
+    char name[64];
+    double seconds;
+} PhaseResult;
+
+static const Workload WORKLOADS[] = {{"small", 200, 80}, {"large", 2000, 800}};
+
+static PhaseResult results[MAX_PHASES];
+static int result_count = 0;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+} // now_seconds
+
+/**
+ * @brief Records the time of a phase; a phase measured again keeps its lower time.
+ */
+static void record_phase(const char *workload, const char *phase, double seconds) {
+    char name[64];
+    snprintf(name, sizeof(name), "%s/%s", workload, phase);
+    printf("%-28s %.6f s\n", name, seconds);
+    for (int i = 0; i < result_count; i++) {
+        if (strcmp(results[i].name, name) != 0) continue;
+        if (seconds < results[i].seconds) results[i].seconds = seconds;
+        return;
+    }
+    if (result_count == MAX_PHASES) return;
+    snprintf(results[result_count].name, sizeof(results[result_count].name), "%s", name);
+    results[result_count].seconds = seconds;
+    result_count++;
+} // record_phase
+
+static int compare_seconds(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+} // compare_seconds
+
+/**
+ * @brief Returns the median of `count` timings, reordering them.
+ */
+static double median_seconds(double *samples, int count) {
+    qsort(samples, count, sizeof(double), compare_seconds);
+    return count % 2 ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) / 2.0;
+} // median_seconds
+
+/**
+ * @brief Times a fixed workload that does not depend on the code under test.
+ *
+ * It mixes integer arithmetic with a pass over a buffer larger than the first-level
+ * caches, like the pipeline phases do.
+ */
+static double time_reference(void) {
+    static unsigned int buffer[REFERENCE_WORDS];
+    unsigned int state = 12345;
+    double start = now_seconds();
+    for (int i = 0; i < REFERENCE_WORDS; i++) buffer[i] = test_random(&state);
+    unsigned int sum = 0;
+    for (int pass = 0; pass < 24; pass++) {
+        for (int i = 0; i < REFERENCE_WORDS; i++) sum += buffer[i] % 7 == 0 ? buffer[i] >> 3 : 1;
+    }
+    double seconds = now_seconds() - start;
+    if (sum == 0) printf("Reference checksum is zero.\n"); // Keeps the loops from being optimized away
+    return seconds;
+} // time_reference
+
+/**
+ * @brief Writes a random dataset as CSV in the format accepted by `parse_csv`.
+ */
+static void write_workload_csv(const char *path, int rows, int with_capacity, unsigned int *state) {
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        perror("Failed to write benchmark input");
+        exit(EXIT_FAILURE);
+    }
+    fprintf(file, with_capacity ? "Name,Attributes,Capacity\n" : "Name,Attributes\n");
+    for (int i = 0; i < rows; i++) {
+        fprintf(file, "%c%d,", with_capacity ? 'M' : 'E', i);
+        int count = 1 + test_random(state) % 5;
+        for (int a = 0; a < count; a++) {
+            fprintf(file, "%s%s", a ? "|" : "", TEST_ATTRIBUTES[test_random(state) % TEST_ATTRIBUTE_COUNT]);
+        }
+        if (with_capacity) fprintf(file, ",%d", 1 + test_random(state) % 3);
+        fprintf(file, "\n");
+    }
+    fclose(file);
+} // write_workload_csv
+
+/**
+ * @brief Data that the phases of one repetition read and write.
+ */
+typedef struct {
+    PairingContext *context;
+    ThreadPool *pool;
+    DataSet *mentees;
+    DataSet *mentors;
+    bool parsed;           ///< Whether the last parse succeeded
+    int *scores;           ///< Matrix of the last scoring engine run, or NULL
+    const int *matrix;     ///< Unweighted matrix of the context, read by the solvers
+    int n;
+    int m;
+    int *matches;
+    int *capacity;
+    BucketScratch buckets;
+    StableScratch stable;
+    StreamMatcher *matcher;
+} PhaseState;
+
+/**
+ * @brief One step of a timed phase.
+ */
+typedef void (*PhaseStep)(PhaseState *state);
+
+/**
+ * @brief Times one phase, repeating it until the timed rounds add up to `MIN_SAMPLE_SECONDS`.
+ *
+ * @param prepare Untimed step run before each round, such as restoring capacities (may be NULL).
+ * @param body The step being timed.
+ * @return The mean time of one round.
+ */
+static double time_phase(PhaseStep prepare, PhaseStep body, PhaseState *state) {
+    double total = 0.0;
+    int rounds = 0;
+    do {
+        if (prepare) prepare(state);
+        double start = now_seconds();
+        body(state);
+        total += now_seconds() - start;
+        rounds++;
+    } while (total < MIN_SAMPLE_SECONDS);
+    return total / rounds;
+} // time_phase
+
+static void release_datasets(PhaseState *state) {
+    free_dataset(state->mentees);
+    free_dataset(state->mentors);
+    state->mentees = state->mentors = NULL;
+} // release_datasets
+
+static void parse_inputs(PhaseState *state) {
+    bool ok1, ok2;
+    state->mentees = parse_csv("mentees.csv", &ok1);
+    state->mentors = parse_csv("mentors.csv", &ok2);
+    state->parsed = ok1 && ok2;
+} // parse_inputs
+
+static void release_scores(PhaseState *state) {
+    free(state->scores);
+    state->scores = NULL;
+} // release_scores
+
+static void score_threaded(PhaseState *state) {
+    match_datasets(state->mentees, state->mentors, &state->scores);
+} // score_threaded
+
+static void score_sharded(PhaseState *state) {
+    match_datasets_sharded(state->mentees, state->mentors, &state->scores, 4, NULL, NULL);
+} // score_sharded
+
+static void score_context(PhaseState *state) {
+    pairing_score(state->context, state->mentees, state->mentors, NULL);
+} // score_context
+
+static void restore_capacity(PhaseState *state) {
+    for (int j = 0; j < state->m; j++) state->capacity[j] = state->mentors->rows[j].capacity;
+} // restore_capacity
+
+static void solve_sequential(PhaseState *state) {
+    for (int i = 0; i < state->n; i++) {
+        state->matches[i] = select_best_mentor(state->matrix + (size_t)i * state->m, state->m, state->capacity);
+        if (state->matches[i] != -1) state->capacity[state->matches[i]]--;
+    }
+} // solve_sequential
+
+static void solve_bucketed(PhaseState *state) {
+    assign_by_score_buckets(state->matrix, state->n, state->m, state->capacity, state->matches, &state->buckets,
+                            NULL);
+} // solve_bucketed
+
+static void solve_stable(PhaseState *state) {
+    assign_stable_matching(state->matrix, state->n, state->m, state->capacity, state->matches, state->pool,
+                           &state->stable, NULL);
+} // solve_stable
+
+static void write_output(PhaseState *state) {
+    pairing_write_output(state->context, "output.csv", state->mentees, state->mentors, state->matches, false, NULL);
+} // write_output
+
+static void release_matcher(PhaseState *state) {
+    if (state->matcher) stream_matcher_destroy(state->matcher);
+    state->matcher = NULL;
+} // release_matcher
+
+// Each round needs a fresh matcher, since assigning uses up its capacity; building it is not timed
+static void rebuild_matcher(PhaseState *state) {
+    release_matcher(state);
+    state->matcher = stream_matcher_create(state->mentors, NULL, thread_pool_size(state->pool));
+} // rebuild_matcher
+
+static void stream_match(PhaseState *state) {
+    stream_matcher_assign(state->matcher, state->mentees->rows, state->n, state->matches, NULL);
+} // stream_match
+
+/**
+ * @brief Times every phase of one workload.
+ */
+static void run_workload(const Workload *workload, PairingContext *context, ThreadPool *pool) {
+    unsigned int seed = 99;
+    write_workload_csv("mentees.csv", workload->mentees, 0, &seed);
+    write_workload_csv("mentors.csv", workload->mentors, 1, &seed);
+
+    double samples[PHASE_COUNT][REPEATS];
+
+    int n = workload->mentees;
+    int m = workload->mentors;
+    PhaseState state = {.context = context, .pool = pool, .n = n, .m = m};
+    state.matches = malloc(n * sizeof(int));
+    state.capacity = malloc(m * sizeof(int));
+
+    for (int r = 0; r < REPEATS; r++) {
+        samples[0][r] = time_phase(release_datasets, parse_inputs, &state);
+        if (!state.parsed) {
+            fprintf(stderr, "Failed to parse benchmark inputs.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        samples[1][r] = time_phase(release_scores, score_threaded, &state);
+        samples[2][r] = time_phase(release_scores, score_sharded, &state);
+        release_scores(&state);
+
+        // Weighted scoring runs its own kernel and is timed next to the unweighted one it is gated against
+        AttributeWeights weights;
+        init_attribute_weights(&weights);
+        compute_idf_weights(&weights, state.mentees, state.mentors);
+        pairing_set_weights(context, &weights);
+        samples[9][r] = time_phase(NULL, score_context, &state);
+        pairing_set_weights(context, NULL);
+        free_attribute_weights(&weights);
+
+        // The solvers below use the unweighted matrix, so their timings exclude scoring
+        samples[3][r] = time_phase(NULL, score_context, &state);
+        state.matrix = pairing_scores(context);
+        samples[4][r] = time_phase(restore_capacity, solve_sequential, &state);
+        samples[5][r] = time_phase(restore_capacity, solve_bucketed, &state);
+        samples[6][r] = time_phase(restore_capacity, solve_stable, &state);
+        samples[7][r] = time_phase(NULL, write_output, &state);
+
+        // Online matching scores and assigns each mentee from the mentor index
+        samples[8][r] = time_phase(rebuild_matcher, stream_match, &state);
+        release_matcher(&state);
+
+        samples[10][r] = time_reference();
+    }
+
+    static const char *phases[] = {"parse",          "score_threaded", "score_sharded", "score_context",
+                                   "solve_sequential", "solve_bucketed", "solve_stable",  "write_output",
+                                   "stream_match",   "score_weighted", "reference"};
+    double median[PHASE_COUNT];
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        median[p] = median_seconds(samples[p], REPEATS);
+        record_phase(workload->name, phases[p], median[p]);
+    }
+    for (int p = 4; p < 9; p++) {
+        if (p == 7) continue; // Not a solver
+        printf("%s/%s throughput: %.0f mentees/s\n", workload->name, phases[p], median[p] > 0 ? n / median[p] : 0.0);
+    }
+
+    release_datasets(&state);
+    free(state.matches);
+    free(state.capacity);
+    free_bucket_scratch(&state.buckets);
+    free_stable_scratch(&state.stable);
+    remove("mentees.csv");
+    remove("mentors.csv");
+    remove("output.csv");
+} // run_workload
+
+/**
+ * @brief Writes the measured timings as a baseline file.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+static int write_baseline(const char *path) {
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        perror("Failed to write baseline");
+        return 0;
+    }
+    fprintf(file, "# phase seconds\n");
+    for (int i = 0; i < result_count; i++) {
+        fprintf(file, "%s %.6f\n", results[i].name, results[i].seconds);
+    }
+    fclose(file);
+    printf("Baseline written to %s\n", path);
+    return 1;
+} // write_baseline
+
+/**
+ * @brief Returns the phase that a phase is gated against: `reference` or a `RELATIVE_PHASES` entry.
+ */
+static const char *reference_phase(const char *phase) {
+    const char *slash = strchr(phase, '/');
+    const char *suffix = slash ? slash + 1 : phase;
+    for (size_t k = 0; k < sizeof(RELATIVE_PHASES) / sizeof(RELATIVE_PHASES[0]); k++) {
+        if (strcmp(suffix, RELATIVE_PHASES[k][0]) == 0) return RELATIVE_PHASES[k][1];
+    }
+    return "reference";
+} // reference_phase
+
+/**
+ * @brief Returns the measured or baseline time of the phase a phase is gated against.
+ *
+ * @return The reference time, or 0 if there is none.
+ */
+static double reference_seconds(const PhaseResult *phases, int count, const char *phase) {
+    const char *slash = strchr(phase, '/');
+    int prefix = slash ? (int)(slash - phase) : (int)strlen(phase);
+    char name[64];
+    snprintf(name, sizeof(name), "%.*s/%s", prefix, phase, reference_phase(phase));
+    for (int i = 0; i < count; i++) {
+        if (strcmp(phases[i].name, name) == 0) return phases[i].seconds;
+    }
+    return 0.0;
+} // reference_seconds
+
+/**
+ * @brief Compares the measured timings with a baseline file.
+ *
+ * Each baseline time is first scaled by how much the reference of its workload (or,
+ * for `RELATIVE_PHASES`, the phase it is paired with) sped up or slowed down since the
+ * baseline was recorded. Baselines without a reference are compared as they are. A phase
+ * that is in the baseline but was not measured, or the other way round, fails the
+ * comparison, since the baseline no longer matches the benchmark and must be recorded again.
+ *
+ * @param path Path to the baseline file.
+ * @param tolerance Allowed slowdown in percent.
+ * @param report Whether to print the regressed phases and a summary.
+ * @return 1 if no phase regressed beyond the tolerance, 0 otherwise.
+ */
+static int compare_baseline(const char *path, double tolerance, bool report) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror("Failed to read baseline");
+        return 0;
+    }
+
+    PhaseResult baselines[MAX_PHASES];
+    int baseline_count = 0;
+    char line[256];
+    while (baseline_count < MAX_PHASES && fgets(line, sizeof(line), file)) {
+        PhaseResult *entry = &baselines[baseline_count];
+        if (line[0] == '#' || sscanf(line, "%63s %lf", entry->name, &entry->seconds) != 2) continue;
+        baseline_count++;
+    }
+    fclose(file);
+
+    int ok = 1;
+    for (int i = 0; i < result_count; i++) {
+        bool listed = false;
+        for (int b = 0; b < baseline_count && !listed; b++) listed = strcmp(baselines[b].name, results[i].name) == 0;
+        if (listed) continue;
+        if (report) printf("UNTRACKED  %-24s measured but not in the baseline\n", results[i].name);
+        ok = 0;
+    }
+
+    for (int b = 0; b < baseline_count; b++) {
+        const char *name = baselines[b].name;
+        bool measured = false;
+        for (int i = 0; i < result_count && !measured; i++) measured = strcmp(results[i].name, name) == 0;
+        if (!measured) {
+            if (report) printf("MISSING    %-24s in the baseline but not measured\n", name);
+            ok = 0;
+            continue;
+        }
+        if (strstr(name, "/reference")) continue;
+
+        double scale = 1.0;
+        double measured_reference = reference_seconds(results, result_count, name);
+        double baseline_reference = reference_seconds(baselines, baseline_count, name);
+        if (measured_reference > 0 && baseline_reference > 0) scale = measured_reference / baseline_reference;
+        double expected = baselines[b].seconds * scale;
+
+        for (int i = 0; i < result_count; i++) {
+            if (strcmp(results[i].name, name) != 0) continue;
+
+            double limit = expected * (1.0 + tolerance / 100.0);
+            if (results[i].seconds > limit) {
+                if (report) printf("REGRESSION %-24s %.6f s (baseline %.6f s x %.2f %s, +%.1f%%)\n", name,
+                       results[i].seconds, baselines[b].seconds, scale, reference_phase(name),
+                       100.0 * (results[i].seconds - expected) / expected);
+                ok = 0;
+            }
+        }
+    }
+
+    if (report) {
+        printf(ok ? "No phase regressed more than %.1f%%.\n"
+                  : "Performance regressions beyond %.1f%% or phases missing from the baseline detected.\n",
+               tolerance);
+    }
+    return ok;
+} // compare_baseline
+
+/**
+ * @brief Times every workload in the scratch directory `dir`, then returns to `cwd`.
+ *
+ * @return 1 on success, 0 if a directory cannot be entered.
+ */
+static int measure_workloads(const char *dir, const char *cwd) {
+    if (chdir(dir) != 0) {
+        perror("Failed to enter benchmark directory");
+        return 0;
+    }
+    PairingContext *context = pairing_create(0);
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    ThreadPool *pool = thread_pool_create(cpus > 0 ? (int)cpus : 1);
+    for (size_t w = 0; w < sizeof(WORKLOADS) / sizeof(WORKLOADS[0]); w++) {
+        run_workload(&WORKLOADS[w], context, pool);
+    }
+    thread_pool_destroy(pool);
+    pairing_destroy(context);
+    return chdir(cwd) == 0;
+} // measure_workloads
+
+int main(int argc, char *argv[]) {
+    const char *baseline = NULL;
+    const char *write_path = NULL;
+    double tolerance = DEFAULT_TOLERANCE;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baseline = argv[++i];
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--write-baseline") == 0 && i + 1 < argc) {
+            write_path = argv[++i];
+        } else {
+            printf("Usage: %s [--baseline <file> [--tolerance <percent>]] [--write-baseline <file>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Work in a scratch directory; benchmark inputs and outputs are temporary
+    char cwd[1024];
+    char dir[] = "/tmp/pairing_benchmark_XXXXXX";
+    if (!getcwd(cwd, sizeof(cwd)) || !mkdtemp(dir)) {
+        perror("Failed to create benchmark directory");
+        return EXIT_FAILURE;
+    }
+
+    int ok = measure_workloads(dir, cwd);
+    if (ok && write_path) ok = write_baseline(write_path);
+
+    // A phase that looks slower is measured once more, so a burst of load on the machine
+    // during one run does not fail the gate; each phase keeps its lower median
+    if (ok && baseline && !compare_baseline(baseline, tolerance, false)) {
+        printf("Some phases look slower than the baseline; measuring again.\n");
+        ok = measure_workloads(dir, cwd);
+    }
+    if (ok && baseline) ok = compare_baseline(baseline, tolerance, true);
+    rmdir(dir);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+} // main
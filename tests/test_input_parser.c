@@ -0,0 +1,375 @@
+/**
+ * @file test_input_parser.c
+ * @brief Tests for the CSV parser and the dataset serialization used by checkpoints.
+ *
+ * Checks the parsed fields of a known CSV file and verifies that datasets, score
+ * matrices and solver states survive a checkpoint round trip unchanged, so the
+ * parsing and resume code paths agree, and that damaged checkpoints are rejected. Also
+ * checks that result stores answer lookups for what was written to them, and that
+ * attribute weight files are read and that malformed ones are rejected.
+ */
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "attribute_weights.h"
+#include "checkpoint.h"
+#include "input_parser.h"
+#include "result_store.h"
+#include "test_utils.h"
+
+/**
+ * @brief Compares two datasets field by field.
+ *
+ * @return true if both datasets hold the same rows.
+ */
+static bool datasets_equal(const DataSet *a, const DataSet *b) {
+    if (a->row_count != b->row_count) return false;
+    for (int i = 0; i < a->row_count; i++) {
+        const DataRow *x = &a->rows[i];
+        const DataRow *y = &b->rows[i];
+        if (strcmp(x->name, y->name) != 0 || x->capacity != y->capacity ||
+            x->attributes_count != y->attributes_count) {
+            return false;
+        }
+        for (int j = 0; j < x->attributes_count; j++) {
+            if (strcmp(x->attributes[j], y->attributes[j]) != 0) return false;
+        }
+    }
+    return true;
+} // datasets_equal
+
+/**
+ * @brief Parses a small CSV file with known contents.
+ */
+static void test_parse_known_file(const char *dir) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/mentors.csv", dir);
+    FILE *file = fopen(path, "w");
+    fprintf(file, "Name,Attributes,Capacity\n");
+    fprintf(file, "George,AI|ML,2\n");
+    fprintf(file, "Holly,Web,1\n");
+    fclose(file);
+
+    bool success = false;
+    DataSet *dataset = parse_csv(path, &success);
+    CHECK(success);
+    CHECK(dataset && dataset->row_count == 2);
+    if (dataset && dataset->row_count == 2) {
+        CHECK(strcmp(dataset->rows[0].name, "George") == 0);
+        CHECK(dataset->rows[0].capacity == 2);
+        CHECK(dataset->rows[0].attributes_count >= 2);
+        CHECK(strcmp(dataset->rows[0].attributes[0], "AI") == 0);
+        CHECK(strcmp(dataset->rows[0].attributes[1], "ML") == 0);
+        CHECK(strcmp(dataset->rows[1].name, "Holly") == 0);
+        CHECK(dataset->rows[1].capacity == 1);
+        CHECK(strcmp(dataset->rows[1].attributes[0], "Web") == 0);
+    }
+    free_dataset(dataset);
+
+    // Missing files are reported rather than crashing
+    snprintf(path, sizeof(path), "%s/missing.csv", dir);
+    CHECK(parse_csv(path, &success) == NULL);
+    CHECK(!success);
+} // test_parse_known_file
+
+/**
+ * @brief FNV-1a over a buffer, as used for checkpoint checksums.
+ */
+static uint64_t fnv1a(const unsigned char *data, size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) hash = (hash ^ data[i]) * 1099511628211ULL;
+    return hash;
+} // fnv1a
+
+/**
+ * @brief Writes `payload` followed by its correct checksum.
+ */
+static void write_checksummed(const char *path, const unsigned char *payload, size_t size) {
+    FILE *file = fopen(path, "wb");
+    uint64_t checksum = fnv1a(payload, size);
+    fwrite(payload, 1, size, file);
+    fwrite(&checksum, sizeof(checksum), 1, file);
+    fclose(file);
+} // write_checksummed
+
+/**
+ * @brief Round-trips random datasets and solver states through checkpoint files.
+ */
+static void test_checkpoint_round_trip(const char *dir) {
+    char path[256];
+    char solver_path[300];
+    snprintf(path, sizeof(path), "%s/test.ckpt", dir);
+    snprintf(solver_path, sizeof(solver_path), "%s%s", path, SOLVER_CHECKPOINT_SUFFIX);
+    unsigned int state = 12345;
+
+    for (int trial = 0; trial < 20; trial++) {
+        int n = test_random(&state) % 12;
+        int m = 1 + test_random(&state) % 6;
+        DataSet *mentees = make_random_dataset(n, TEST_ATTRIBUTE_COUNT, 0, &state);
+        DataSet *mentors = make_random_dataset(m, TEST_ATTRIBUTE_COUNT, 3, &state);
+        int *scores = malloc((n * m > 0 ? n * m : 1) * sizeof(int));
+        for (int k = 0; k < n * m; k++) scores[k] = test_random(&state) % 5;
+        int *assigned = malloc((n > 0 ? n : 1) * sizeof(int));
+        int *remaining = malloc(m * sizeof(int));
+        for (int i = 0; i < n; i++) assigned[i] = (int)(test_random(&state) % (m + 1)) - 1;
+        for (int j = 0; j < m; j++) remaining[j] = test_random(&state) % 3;
+
+        Checkpoint checkpoint = {.category = "mentee_mentor",
+                                 .identity = {.file1_fingerprint = test_random(&state),
+                                              .file2_fingerprint = test_random(&state),
+                                              .solver = SOLVER_SEQUENTIAL,
+                                              .weight_mode = WEIGHTS_FILE,
+                                              .weights_fingerprint = 99},
+                                 .dataset1 = mentees,
+                                 .dataset2 = mentors,
+                                 .compatibility_scores = scores,
+                                 .solver = {.next_row = n / 2, .row_assigned = assigned, .capacity_remaining = remaining}};
+        CHECK(save_checkpoint(path, &checkpoint));
+
+        bool success = false;
+        Checkpoint *loaded = load_checkpoint(path, &success);
+        CHECK(success && loaded);
+        if (loaded) {
+            CHECK(loaded->stage == CHECKPOINT_SCORED && loaded->run_id == checkpoint.run_id);
+            CHECK(strcmp(loaded->category, "mentee_mentor") == 0);
+            CHECK(memcmp(&loaded->identity, &checkpoint.identity, sizeof(CheckpointIdentity)) == 0);
+            CHECK(datasets_equal(mentees, loaded->dataset1));
+            CHECK(datasets_equal(mentors, loaded->dataset2));
+            CHECK(n * m == 0 || memcmp(scores, loaded->compatibility_scores, n * m * sizeof(int)) == 0);
+        }
+        free_checkpoint(loaded);
+
+        // Solver progress is a small separate record that does not rewrite the matrix
+        struct stat before, after;
+        CHECK(stat(path, &before) == 0);
+        CHECK(save_solver_checkpoint(path, &checkpoint));
+        CHECK(stat(path, &after) == 0 && after.st_ino == before.st_ino);
+        struct stat record;
+        CHECK(stat(solver_path, &record) == 0 && record.st_size < 64 + (off_t)(n + m) * (off_t)sizeof(int));
+        loaded = load_checkpoint(path, &success);
+        CHECK(success && loaded && loaded->stage == CHECKPOINT_SOLVING);
+        if (loaded && loaded->stage == CHECKPOINT_SOLVING) {
+            CHECK(loaded->solver.next_row == n / 2);
+            CHECK(n == 0 || memcmp(loaded->solver.row_assigned, assigned, n * sizeof(int)) == 0);
+            CHECK(memcmp(loaded->solver.capacity_remaining, remaining, m * sizeof(int)) == 0);
+        }
+        free_checkpoint(loaded);
+
+        // A path too long for its temporary or solver file is refused instead of truncated
+        if (trial == 0) {
+            char *long_path = malloc(PATH_MAX);
+            memset(long_path, 'c', PATH_MAX - 3);
+            long_path[PATH_MAX - 3] = '\0';
+            CHECK(!save_checkpoint(long_path, &checkpoint));
+            CHECK(!save_solver_checkpoint(long_path, &checkpoint));
+            free(long_path);
+        }
+
+        // Solver state saved for another checkpoint is rejected, and a new checkpoint discards it
+        checkpoint.run_id ^= 1;
+        CHECK(save_solver_checkpoint(path, &checkpoint));
+        CHECK(load_checkpoint(path, &success) == NULL && !success);
+        CHECK(save_checkpoint(path, &checkpoint));
+        CHECK(access(solver_path, F_OK) != 0);
+
+        free(assigned);
+        free(remaining);
+        free(scores);
+        free_dataset(mentees);
+        free_dataset(mentors);
+    }
+
+    // A flipped byte is caught by the checksum
+    FILE *file = fopen(path, "r+");
+    fseek(file, 20, SEEK_SET);
+    int byte = fgetc(file);
+    fseek(file, 20, SEEK_SET);
+    fputc(byte ^ 0x40, file);
+    fclose(file);
+    bool success = true;
+    CHECK(load_checkpoint(path, &success) == NULL);
+    CHECK(!success);
+
+    // Counts that the file cannot hold are rejected before anything is allocated for them
+    unsigned char payload[128];
+    size_t size = 0;
+    int32_t version = 2, category_length = 1, row_count = 0x7fffffff;
+    memcpy(payload + size, "PAIRCKPT", 8), size += 8;
+    memcpy(payload + size, &version, 4), size += 4;
+    memcpy(payload + size, &category_length, 4), size += 4;
+    payload[size++] = 'x';
+    memset(payload + size, 0, sizeof(CheckpointIdentity)), size += 32;
+    memcpy(payload + size, &row_count, 4), size += 4;
+    write_checksummed(path, payload, size);
+    success = true;
+    CHECK(load_checkpoint(path, &success) == NULL);
+    CHECK(!success);
+
+    // A truncated checkpoint is rejected
+    write_checksummed(path, payload, size);
+    CHECK(truncate(path, size / 2) == 0);
+    success = true;
+    CHECK(load_checkpoint(path, &success) == NULL);
+    CHECK(!success);
+    remove_checkpoint(path);
+
+    // No checkpoint at all is not an error
+    success = false;
+    CHECK(load_checkpoint(path, &success) == NULL && success);
+} // test_checkpoint_round_trip
+
+/**
+ * @brief Writes random results to a result store and looks every mentee up again.
+ *
+ * Also checks that a store mapped before a rewrite stays readable, that repeated
+ * names resolve to their first row, and that truncated stores are rejected.
+ */
+static void test_result_store_round_trip(const char *dir) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/results.idx", dir);
+    unsigned int state = 777;
+
+    for (int trial = 0; trial < 20; trial++) {
+        bool is_participant_panel = trial % 2 == 1;
+        int n = 1 + test_random(&state) % 12;
+        int m = 1 + test_random(&state) % 6;
+        DataSet *mentees = make_random_dataset(n, TEST_ATTRIBUTE_COUNT, 0, &state);
+        DataSet *mentors = make_random_dataset(m, TEST_ATTRIBUTE_COUNT, 3, &state);
+        int *scores = malloc(n * m * sizeof(int));
+        int *matches = malloc(n * sizeof(int));
+        for (int k = 0; k < n * m; k++) scores[k] = test_random(&state) % 4;
+        for (int i = 0; i < n; i++) matches[i] = (int)(test_random(&state) % (m + 1)) - 1;
+        if (n > 1) {
+            free(mentees->rows[n - 1].name);
+            mentees->rows[n - 1].name = strdup(mentees->rows[0].name);
+        }
+
+        // A path too long for the temporary file is refused instead of truncated
+        if (trial == 0) {
+            char *long_path = malloc(PATH_MAX);
+            memset(long_path, 'r', PATH_MAX - 3);
+            long_path[PATH_MAX - 3] = '\0';
+            CHECK(!write_result_store(long_path, mentees, mentors, matches, scores, is_participant_panel));
+            free(long_path);
+        }
+
+        ResultStore *previous = trial > 0 ? open_result_store(path) : NULL;
+        CHECK(trial == 0 || previous);
+        CHECK(write_result_store(path, mentees, mentors, matches, scores, is_participant_panel));
+
+        // A store mapped before the rewrite keeps its own contents
+        ResultEntry entry;
+        if (previous) CHECK(result_store_lookup(previous, "R0", &entry) && entry.row == 0);
+        close_result_store(previous);
+
+        ResultStore *store = open_result_store(path);
+        CHECK(store != NULL);
+        for (int i = 0; store && i < (n > 1 ? n - 1 : n); i++) {
+            CHECK(result_store_lookup(store, mentees->rows[i].name, &entry));
+            CHECK(entry.row == i && strcmp(entry.name, mentees->rows[i].name) == 0);
+            int k = 0;
+            for (int j = 0; j < m; j++) {
+                int score = scores[i * m + j];
+                if (is_participant_panel ? score <= 0 : matches[i] != j) continue;
+                CHECK(k < entry.match_count && entry.match_indices[k] == j && entry.scores[k] == score);
+                k++;
+            }
+            CHECK(k == entry.match_count);
+        }
+        if (store) {
+            CHECK(result_store_is_participant_panel(store) == is_participant_panel);
+            CHECK(n == 1 || (result_store_lookup(store, mentees->rows[n - 1].name, &entry) && entry.row == 0));
+            CHECK(!result_store_lookup(store, "Nobody", &entry));
+            for (int j = 0; j < m; j++) CHECK(strcmp(result_store_target_name(store, j), mentors->rows[j].name) == 0);
+            CHECK(result_store_target_name(store, m) == NULL);
+        }
+        close_result_store(store);
+
+        free(matches);
+        free(scores);
+        free_dataset(mentees);
+        free_dataset(mentors);
+    }
+
+    // A header whose hash index reaches past the end of the file is rejected
+    FILE *file = fopen(path, "r+");
+    uint32_t bucket_count = 1u << 30;
+    fseek(file, 28, SEEK_SET); // magic, then version, mode and three counts
+    fwrite(&bucket_count, sizeof(bucket_count), 1, file);
+    fclose(file);
+    CHECK(open_result_store(path) == NULL);
+
+    // A store cut short of the sections its header describes is rejected
+    struct stat st;
+    CHECK(stat(path, &st) == 0);
+    CHECK(truncate(path, st.st_size - 8) == 0);
+    CHECK(open_result_store(path) == NULL);
+    CHECK(truncate(path, 128) == 0);
+    CHECK(open_result_store(path) == NULL);
+    remove(path);
+} // test_result_store_round_trip
+
+/**
+ * @brief Writes `contents` to a weights file and tries to load it.
+ *
+ * @return The result of `load_attribute_weights`.
+ */
+static int load_weights_text(const char *path, const char *contents, AttributeWeights *weights) {
+    FILE *file = fopen(path, "w");
+    fputs(contents, file);
+    fclose(file);
+    init_attribute_weights(weights);
+    return load_attribute_weights(weights, path);
+} // load_weights_text
+
+/**
+ * @brief Reads known weights files, including malformed ones.
+ */
+static void test_attribute_weights(const char *dir) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/weights.csv", dir);
+
+    AttributeWeights weights;
+    CHECK(load_weights_text(path, "Attribute,Weight\nAI,5\n  Data Science , 2 \n\nArt,0\nAI,7\n", &weights));
+    CHECK(attribute_weight(&weights, "AI") == 7); // Later rows replace earlier ones
+    CHECK(attribute_weight(&weights, "Data Science") == 2);
+    CHECK(attribute_weight(&weights, "Art") == 0);
+    CHECK(attribute_weight(&weights, "Web") == DEFAULT_ATTRIBUTE_WEIGHT);
+    CHECK(attribute_weight(NULL, "AI") == DEFAULT_ATTRIBUTE_WEIGHT);
+    free_attribute_weights(&weights);
+
+    static const char *malformed[] = {"", "Attribute,Weight\nAI\n", "Attribute,Weight\nAI,x\n",
+                                      "Attribute,Weight\nAI,3x\n", "Attribute,Weight\n,3\n",
+                                      "Attribute,Weight\nAI,-1\n", "Attribute,Weight\nAI,1001\n"};
+    for (size_t k = 0; k < sizeof(malformed) / sizeof(malformed[0]); k++) {
+        CHECK(!load_weights_text(path, malformed[k], &weights));
+        free_attribute_weights(&weights);
+    }
+    remove(path);
+
+    init_attribute_weights(&weights);
+    CHECK(!load_attribute_weights(&weights, path));
+    free_attribute_weights(&weights);
+} // test_attribute_weights
+
+int main(void) {
+    char dir[] = "/tmp/test_input_parser_XXXXXX";
+    if (!mkdtemp(dir)) {
+        perror("Failed to create temporary directory");
+        return EXIT_FAILURE;
+    }
+
+    test_parse_known_file(dir);
+    test_checkpoint_round_trip(dir);
+    test_result_store_round_trip(dir);
+    test_attribute_weights(dir);
+
+    char path[256];
+    snprintf(path, sizeof(path), "%s/mentors.csv", dir);
+    remove(path);
+    rmdir(dir);
+    return test_summary("test_input_parser");
+} // main
@@ -0,0 +1,470 @@
+/**
+ * @file test_matching_engine.c
+ * @brief Differential tests for every compatibility scoring code path.
+ *
+ * Random instances are scored with a reference implementation of the scoring rule
+ * and with the threaded engine, the sequential engine, the multi-process engine and
+ * the interned library context. All of them must produce the same matrix, and the
+ * analytics gathered while scoring must match a separate pass over that matrix.
+ * With attribute weights, the weighted kernels must agree with a weighted reference,
+ * and switching weights off must restore the unweighted scores. A cleared attribute
+ * dictionary must be refilled in its existing buffers. Sharded scoring
+ * must only reap its own workers, never other children of the process.
+ * A wrapped score matrix must release its storage exactly once, in `score_matrix_free`.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "attribute_dictionary.h"
+#include "attribute_weights.h"
+#include "matching_engine.h"
+#include "pairing.h"
+#include "process_sharding.h"
+#include "score_matrix.h"
+#include "solution_selector.h"
+#include "test_utils.h"
+
+/**
+ * @brief Reference scoring rule: number of equal attribute pairs.
+ */
+static int reference_score(const DataRow *a, const DataRow *b) {
+    int score = 0;
+    for (int i = 0; i < a->attributes_count; i++) {
+        for (int j = 0; j < b->attributes_count; j++) {
+            if (strcmp(a->attributes[i], b->attributes[j]) == 0) score++;
+        }
+    }
+    return score;
+} // reference_score
+
+/**
+ * @brief Reference weighted rule: sum of the weights of equal attribute pairs.
+ *
+ * `weights[k]` is the weight of `TEST_ATTRIBUTES[k]`.
+ */
+static int reference_weighted_score(const DataRow *a, const DataRow *b, const int *weights) {
+    int score = 0;
+    for (int i = 0; i < a->attributes_count; i++) {
+        int weight = 0;
+        for (int k = 0; k < TEST_ATTRIBUTE_COUNT; k++) {
+            if (strcmp(a->attributes[i], TEST_ATTRIBUTES[k]) == 0) weight = weights[k];
+        }
+        for (int j = 0; j < b->attributes_count; j++) {
+            if (strcmp(a->attributes[i], b->attributes[j]) == 0) score += weight;
+        }
+    }
+    return score;
+} // reference_weighted_score
+
+/**
+ * @brief Builds a dataset from pipe-separated attribute lists, one per row.
+ */
+static DataSet *make_dataset(int row_count, const char *const *attributes) {
+    DataSet *dataset = malloc(sizeof(DataSet));
+    dataset->row_count = row_count;
+    dataset->rows = calloc(row_count, sizeof(DataRow));
+    for (int i = 0; i < row_count; i++) {
+        char line[MAX_LINE_LENGTH];
+        snprintf(line, sizeof(line), "Row,%s", attributes[i]);
+        CHECK(parse_csv_row(line, &dataset->rows[i]));
+    }
+    return dataset;
+} // make_dataset
+
+/**
+ * @brief Checks IDF weights on datasets with known attribute frequencies.
+ */
+static void test_idf_weights(void) {
+    static const char *first[] = {"AI|AI|Law", "AI"};
+    static const char *second[] = {"AI|Web", "AI|Web"};
+    DataSet *dataset1 = make_dataset(2, first);
+    DataSet *dataset2 = make_dataset(2, second);
+
+    AttributeWeights weights;
+    init_attribute_weights(&weights);
+    CHECK(set_attribute_weight(&weights, "Art", 9));
+    CHECK(compute_idf_weights(&weights, dataset1, dataset2));
+    CHECK(attribute_weight(&weights, "AI") == 1);   // In every row: ln(1) is raised to 1
+    CHECK(attribute_weight(&weights, "Web") == 7);  // 2 of 4 rows: round(10 * ln(2))
+    CHECK(attribute_weight(&weights, "Law") == 14); // 1 of 4 rows: round(10 * ln(4))
+    CHECK(attribute_weight(&weights, "Art") == 9);  // Not in the datasets, so kept
+    CHECK(calculate_weighted_score(&dataset1->rows[0], &dataset2->rows[0], &weights) == 2);
+
+    free_attribute_weights(&weights);
+    free_dataset(dataset1);
+    free_dataset(dataset2);
+} // test_idf_weights
+
+/**
+ * @brief Checks that a cleared dictionary hands out ids from 0 again without allocating.
+ */
+static void test_dictionary_clear(void) {
+    AttributeDictionary dictionary;
+    init_attribute_dictionary(&dictionary);
+    char name[32];
+    for (int i = 0; i < 200; i++) {
+        snprintf(name, sizeof(name), "First%d", i);
+        CHECK(intern_attribute(&dictionary, name) == i);
+    }
+    CHECK(strcmp(attribute_name(&dictionary, 7), "First7") == 0);
+
+    const char *strings = dictionary.strings;
+    const size_t *offsets = dictionary.offsets;
+    const int *buckets = dictionary.buckets;
+    clear_attribute_dictionary(&dictionary);
+    CHECK(dictionary.count == 0 && find_attribute(&dictionary, "First7") == -1);
+    for (int i = 0; i < 200; i++) {
+        snprintf(name, sizeof(name), "Other%d", i);
+        CHECK(intern_attribute(&dictionary, name) == i);
+    }
+    CHECK(find_attribute(&dictionary, "Other7") == 7 && strcmp(attribute_name(&dictionary, 7), "Other7") == 0);
+    CHECK(dictionary.strings == strings && dictionary.offsets == offsets && dictionary.buckets == buckets);
+    free_attribute_dictionary(&dictionary);
+} // test_dictionary_clear
+
+/**
+ * @brief Checks that the histogram bins span the highest score and merge across widths.
+ */
+static void test_histogram_bins(void) {
+    ScoreAnalytics narrow = {0};
+    ScoreAnalytics wide = {0};
+    CHECK(init_score_analytics(&narrow, 2) && init_score_analytics(&wide, 2));
+    for (int score = 0; score <= 12; score++) record_score(&narrow, score % 2, score);
+    CHECK(narrow.bin_shift == 0 && narrow.bin_count == 13);
+
+    // 1000 needs bins 16 wide to stay within SCORE_HISTOGRAM_MAX_BINS
+    for (int score = 0; score <= 1000; score++) record_score(&wide, 0, score);
+    CHECK(wide.bin_shift == 4 && wide.bin_count == 1000 / 16 + 1);
+    CHECK(wide.column_histograms[0] == 16 && wide.column_histograms[2 * (wide.bin_count - 1)] == 1000 % 16 + 1);
+
+    merge_score_analytics(&narrow, &wide);
+    CHECK(narrow.bin_shift == 4 && narrow.bin_count == wide.bin_count);
+    long total = 0;
+    for (int k = 0; k < narrow.bin_count * 2; k++) total += narrow.column_histograms[k];
+    CHECK(total == 13 + 1001);
+    CHECK(narrow.column_histograms[0] == 16 + 7 && narrow.column_histograms[1] == 6);
+    free_score_analytics(&narrow);
+    free_score_analytics(&wide);
+} // test_histogram_bins
+
+/**
+ * @brief Checks that sharded scoring leaves the exit status of an unrelated child alone.
+ */
+static void test_sharding_spares_other_children(void) {
+    pid_t child = fork();
+    if (child == 0) _exit(42);
+    CHECK(child > 0);
+
+    unsigned int state = 77;
+    DataSet *mentees = make_random_dataset(20, TEST_ATTRIBUTE_COUNT, 0, &state);
+    DataSet *mentors = make_random_dataset(8, TEST_ATTRIBUTE_COUNT, 2, &state);
+    usleep(20000); // Let the child exit before the workers are waited for
+    int *scores = NULL;
+    CHECK(match_datasets_sharded(mentees, mentors, &scores, 3, NULL, NULL));
+    free(scores);
+
+    int status = 0;
+    CHECK(waitpid(child, &status, 0) == child);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 42);
+    free_dataset(mentees);
+    free_dataset(mentors);
+} // test_sharding_spares_other_children
+
+/**
+ * @brief Checks that the coordinator sleeps while its workers score instead of polling them.
+ */
+static void test_sharding_waits_without_polling(void) {
+    unsigned int state = 78;
+    DataSet *mentees = make_random_dataset(3000, TEST_ATTRIBUTE_COUNT, 0, &state);
+    DataSet *mentors = make_random_dataset(300, TEST_ATTRIBUTE_COUNT, 2, &state);
+    struct rusage before, after;
+    struct timespec start, end;
+    getrusage(RUSAGE_SELF, &before);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int *scores = NULL;
+    CHECK(match_datasets_sharded(mentees, mentors, &scores, 2, NULL, NULL));
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    getrusage(RUSAGE_SELF, &after);
+
+    // A 1 ms poll would wake the coordinator about once per millisecond of scoring
+    long elapsed_ms = (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+    long wakeups = after.ru_nvcsw - before.ru_nvcsw;
+    CHECK(elapsed_ms < 50 || wakeups < 20);
+    free(scores);
+    free_dataset(mentees);
+    free_dataset(mentors);
+} // test_sharding_waits_without_polling
+
+static bool matrices_equal(const int *a, const int *b, int count) {
+    return count == 0 || (a && b && memcmp(a, b, count * sizeof(int)) == 0);
+} // matrices_equal
+
+static int storage_releases = 0;
+
+/**
+ * @brief `ScoreStorageRelease` that counts how often it runs.
+ */
+static void count_storage_release(int *scores, size_t size) {
+    (void)size;
+    storage_releases++;
+    free(scores);
+} // count_storage_release
+
+/**
+ * @brief Checks arena alignment and that score matrices release their storage once.
+ */
+static void test_score_matrix(void) {
+    Arena arena;
+    init_arena(&arena, 256);
+    for (size_t size = 1; size < 2048; size = size * 3 + 1) {
+        unsigned char *memory = arena_alloc(&arena, size);
+        CHECK(memory && (size_t)memory % ARENA_ALIGNMENT == 0);
+        memset(memory, 0xab, size); // Oversized requests still get usable memory
+    }
+    ScoreMatrix *in_arena = score_matrix_create(&arena, 7, 5);
+    CHECK(in_arena && in_arena->rows == 7 && in_arena->columns == 5);
+    for (int k = 0; k < 35; k++) in_arena->scores[k] = k;
+    CHECK(score_matrix_row(in_arena, 3)[2] == 17);
+    score_matrix_free(in_arena);
+    free_arena(&arena);
+    CHECK(arena.blocks == NULL && arena.allocated == 0);
+
+    ScoreMatrix *wrapped = score_matrix_wrap(calloc(6, sizeof(int)), 2, 3, count_storage_release);
+    CHECK(storage_releases == 0);
+    score_matrix_free(wrapped);
+    CHECK(storage_releases == 1);
+    score_matrix_free(NULL);
+} // test_score_matrix
+
+/**
+ * @brief A random instance and its reference score matrix.
+ */
+typedef struct {
+    int n;
+    int m;
+    int pool; ///< Number of distinct attributes the rows draw from
+    DataSet *mentees;
+    DataSet *mentors;
+    int *reference;
+} Instance;
+
+/**
+ * @brief Makes a random instance and scores it with the reference rule.
+ */
+static Instance make_instance(unsigned int *state) {
+    Instance instance;
+    instance.n = 1 + test_random(state) % 30;
+    instance.m = 1 + test_random(state) % 12;
+    instance.pool = 2 + test_random(state) % (TEST_ATTRIBUTE_COUNT - 1);
+    instance.mentees = make_random_dataset(instance.n, instance.pool, 0, state);
+    instance.mentors = make_random_dataset(instance.m, instance.pool, 3, state);
+    instance.reference = malloc(instance.n * instance.m * sizeof(int));
+    for (int i = 0; i < instance.n; i++) {
+        for (int j = 0; j < instance.m; j++) {
+            instance.reference[i * instance.m + j] =
+                reference_score(&instance.mentees->rows[i], &instance.mentors->rows[j]);
+        }
+    }
+    return instance;
+} // make_instance
+
+static void free_instance(Instance *instance) {
+    free(instance->reference);
+    free_dataset(instance->mentees);
+    free_dataset(instance->mentors);
+} // free_instance
+
+/**
+ * @brief Checks that every scoring engine produces the reference matrix.
+ */
+static void test_engines_match_reference(void) {
+    unsigned int state = 2024;
+    PairingContext *context = pairing_create(3);
+    CHECK(context != NULL);
+    for (int trial = 0; trial < 40; trial++) {
+        Instance instance = make_instance(&state);
+        int n = instance.n, m = instance.m;
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < m; j++) {
+                CHECK(calculate_score(&instance.mentees->rows[i], &instance.mentors->rows[j]) ==
+                      instance.reference[i * m + j]);
+            }
+        }
+
+        int *threaded = NULL;
+        match_datasets(instance.mentees, instance.mentors, &threaded);
+        CHECK(matrices_equal(instance.reference, threaded, n * m));
+
+        int *sequential = NULL;
+        match_mentees_to_mentors_non_threaded(instance.mentees, instance.mentors, &sequential);
+        CHECK(matrices_equal(instance.reference, sequential, n * m));
+
+        int *sharded = NULL;
+        CHECK(match_datasets_sharded(instance.mentees, instance.mentors, &sharded, 1 + trial % 4, NULL, NULL));
+        CHECK(matrices_equal(instance.reference, sharded, n * m));
+        ScoreMatrix *shared = match_datasets_sharded_matrix(instance.mentees, instance.mentors, 1 + trial % 4, NULL, NULL);
+        CHECK(shared && shared->rows == n && shared->columns == m);
+        CHECK(shared && matrices_equal(instance.reference, shared->scores, n * m));
+        score_matrix_free(shared);
+
+        int *interned = malloc(n * m * sizeof(int));
+        CHECK(pairing_score(context, instance.mentees, instance.mentors, interned));
+        CHECK(matrices_equal(instance.reference, interned, n * m));
+        CHECK(pairing_score(context, instance.mentees, instance.mentors, NULL));
+        CHECK(matrices_equal(instance.reference, pairing_scores(context), n * m));
+
+        free(threaded);
+        free(sequential);
+        free(sharded);
+        free(interned);
+        free_instance(&instance);
+    }
+    pairing_destroy(context);
+} // test_engines_match_reference
+
+/**
+ * @brief Checks that analytics fused into scoring equal a separate pass over the matrix.
+ */
+static void test_fused_analytics(void) {
+    unsigned int state = 2025;
+    PairingContext *context = pairing_create(3);
+    for (int trial = 0; trial < 40; trial++) {
+        Instance instance = make_instance(&state);
+        int n = instance.n, m = instance.m;
+        ScoreAnalytics fused = {0};
+        ScoreAnalytics separate = {0};
+        CHECK(pairing_score_with_analytics(context, instance.mentees, instance.mentors, NULL, &fused));
+        CHECK(init_score_analytics(&separate, m));
+        analyze_score_matrix(&separate, instance.reference, n, m);
+        CHECK(memcmp(fused.match_counts, separate.match_counts, m * sizeof(long)) == 0);
+        CHECK(fused.bin_count == separate.bin_count && fused.bin_shift == separate.bin_shift);
+        CHECK(memcmp(fused.column_histograms, separate.column_histograms,
+                     (size_t)m * separate.bin_count * sizeof(long)) == 0);
+        int max_score = 0;
+        for (int k = 0; k < n * m; k++) max_score = instance.reference[k] > max_score ? instance.reference[k] : max_score;
+        CHECK(fused.bin_count == max_score + 1);
+
+        // Ranking the context's interned ids agrees with interning the datasets again
+        CHECK(compute_attribute_overlaps(&separate, instance.mentees, instance.mentors));
+        CHECK(fused.top_overlap_count == separate.top_overlap_count);
+        for (int k = 0; k < fused.top_overlap_count && k < separate.top_overlap_count; k++) {
+            CHECK(fused.top_overlaps[k].overlaps == separate.top_overlaps[k].overlaps);
+            CHECK(strcmp(fused.top_overlaps[k].attribute, separate.top_overlaps[k].attribute) == 0);
+        }
+
+        // Attribute overlaps add up to the total score when none are cut off the ranking
+        long total_score = 0;
+        long total_overlaps = 0;
+        for (int k = 0; k < n * m; k++) total_score += instance.reference[k];
+        for (int k = 0; k < fused.top_overlap_count; k++) total_overlaps += fused.top_overlaps[k].overlaps;
+        CHECK(instance.pool > TOP_ATTRIBUTE_OVERLAPS || total_overlaps == total_score);
+        free_score_analytics(&fused);
+        free_score_analytics(&separate);
+        free_instance(&instance);
+    }
+    pairing_destroy(context);
+} // test_fused_analytics
+
+/**
+ * @brief Checks that cancelled scoring leaves every pair at 0 and the pool usable afterwards.
+ */
+static void test_cancelled_scoring(void) {
+    unsigned int state = 2026;
+    PairingContext *context = pairing_create(3);
+    for (int trial = 0; trial < 40; trial++) {
+        Instance instance = make_instance(&state);
+        int count = instance.n * instance.m;
+        CancellationToken cancel;
+        init_cancellation_token(&cancel);
+        request_cancellation(&cancel);
+        int *cancelled = NULL;
+        CHECK(match_datasets_sharded(instance.mentees, instance.mentors, &cancelled, 1 + trial % 4, NULL, &cancel));
+        for (int k = 0; k < count; k++) CHECK(cancelled[k] == 0);
+
+        int *interned = malloc(count * sizeof(int));
+        memset(interned, 0xff, count * sizeof(int));
+        pairing_set_cancellation(context, &cancel);
+        CHECK(pairing_score(context, instance.mentees, instance.mentors, interned));
+        for (int k = 0; k < count; k++) CHECK(interned[k] == 0);
+        pairing_set_cancellation(context, NULL);
+        CHECK(pairing_score(context, instance.mentees, instance.mentors, interned));
+        CHECK(matrices_equal(instance.reference, interned, count));
+        free(cancelled);
+        free(interned);
+        free_instance(&instance);
+    }
+    pairing_destroy(context);
+} // test_cancelled_scoring
+
+/**
+ * @brief Checks that the weighted kernels agree with the weighted reference, and that
+ * weights of 1 or no weights at all give the unweighted scores.
+ */
+static void test_weighted_kernels(void) {
+    unsigned int state = 2027;
+    PairingContext *context = pairing_create(3);
+    for (int trial = 0; trial < 40; trial++) {
+        Instance instance = make_instance(&state);
+        int n = instance.n, m = instance.m;
+        int weight_values[TEST_ATTRIBUTE_COUNT];
+        AttributeWeights weights;
+        AttributeWeights unit_weights;
+        init_attribute_weights(&weights);
+        init_attribute_weights(&unit_weights);
+        for (int k = 0; k < TEST_ATTRIBUTE_COUNT; k++) {
+            weight_values[k] = test_random(&state) % 4 ? (int)(test_random(&state) % 6) : DEFAULT_ATTRIBUTE_WEIGHT;
+            if (weight_values[k] != DEFAULT_ATTRIBUTE_WEIGHT || k % 2) {
+                CHECK(set_attribute_weight(&weights, TEST_ATTRIBUTES[k], weight_values[k]));
+            }
+            if (k % 3) CHECK(set_attribute_weight(&unit_weights, TEST_ATTRIBUTES[k], 1));
+        }
+
+        int *weighted = malloc(n * m * sizeof(int));
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < m; j++) {
+                weighted[i * m + j] =
+                    reference_weighted_score(&instance.mentees->rows[i], &instance.mentors->rows[j], weight_values);
+                CHECK(calculate_weighted_score(&instance.mentees->rows[i], &instance.mentors->rows[j], &weights) ==
+                      weighted[i * m + j]);
+            }
+        }
+        int *sharded_weighted = NULL;
+        CHECK(match_datasets_sharded(instance.mentees, instance.mentors, &sharded_weighted, 1 + trial % 4, &weights,
+                                     NULL));
+        CHECK(matrices_equal(weighted, sharded_weighted, n * m));
+        int *interned = malloc(n * m * sizeof(int));
+        pairing_set_weights(context, &weights);
+        CHECK(pairing_score(context, instance.mentees, instance.mentors, interned));
+        CHECK(matrices_equal(weighted, interned, n * m));
+        pairing_set_weights(context, &unit_weights);
+        CHECK(pairing_score(context, instance.mentees, instance.mentors, interned));
+        CHECK(matrices_equal(instance.reference, interned, n * m));
+        pairing_set_weights(context, NULL);
+        CHECK(pairing_score(context, instance.mentees, instance.mentors, interned));
+        CHECK(matrices_equal(instance.reference, interned, n * m));
+        free(interned);
+        free(sharded_weighted);
+        free(weighted);
+        free_attribute_weights(&weights);
+        free_attribute_weights(&unit_weights);
+        free_instance(&instance);
+    }
+    pairing_destroy(context);
+} // test_weighted_kernels
+
+int main(void) {
+    test_score_matrix();
+    test_idf_weights();
+    test_dictionary_clear();
+    test_histogram_bins();
+    test_sharding_spares_other_children();
+    test_sharding_waits_without_polling();
+    test_engines_match_reference();
+    test_fused_analytics();
+    test_cancelled_scoring();
+    test_weighted_kernels();
+    return test_summary("test_matching_engine");
+} // main
@@ -0,0 +1,816 @@
+/**
+ * @file test_solution_selector.c
+ * @brief Checks every assignment engine against a brute-force optimum.
+ *
+ * Small random instances are solved exhaustively. Each engine must return a feasible
+ * assignment whose total score never exceeds the optimum, and reach it when no mentor
+ * can fill up. The sequential and stable engines must reproduce a plain greedy over the
+ * mentees and a textbook deferred acceptance. The bucketed engine must reach
+ * at least half of the optimum (the greedy bound for weighted b-matching) and match a
+ * plain walk over every pair from the highest score down. The pipeline
+ * and library versions of each engine must agree exactly. Local search must never
+ * lower a score, and a cancelled solve must still return a feasible assignment.
+ * The stable engine must leave no blocking pair, whatever the number of threads.
+ * Solves taking their buffers from an arena must match the `malloc` ones, and the
+ * output file must report the scores of the matrix it was given. The online stream
+ * matcher must reproduce the sequential engine, both in memory and from a CSV stream,
+ * and with attribute weights it must reproduce the library with the same weights.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "matching_engine.h"
+#include "output_writer.h"
+#include "pairing.h"
+#include "solution_selector.h"
+#include "stable_matching.h"
+#include "stream_matcher.h"
+#include "test_utils.h"
+
+/**
+ * @brief Exhaustively searches every capacity-feasible assignment.
+ *
+ * @return The highest total score.
+ */
+static int brute_force_optimum(const int *scores, int n, int m, int row, int *capacity) {
+    if (row == n) return 0;
+
+    int best = brute_force_optimum(scores, n, m, row + 1, capacity); // Leave the mentee unmatched
+    for (int j = 0; j < m; j++) {
+        if (capacity[j] <= 0) continue;
+        capacity[j]--;
+        int total = scores[row * m + j] + brute_force_optimum(scores, n, m, row + 1, capacity);
+        capacity[j]++;
+        if (total > best) best = total;
+    }
+    return best;
+} // brute_force_optimum
+
+/**
+ * @brief Checks that an assignment respects every capacity and returns its total score.
+ */
+static int check_feasible_total(const int *matches, const int *scores, const DataSet *mentors, int n) {
+    int m = mentors->row_count;
+    int *used = calloc(m, sizeof(int));
+    int total = 0;
+    for (int i = 0; i < n; i++) {
+        CHECK(matches[i] >= -1 && matches[i] < m);
+        if (matches[i] < 0 || matches[i] >= m) continue;
+        used[matches[i]]++;
+        total += scores[i * m + matches[i]];
+    }
+    for (int j = 0; j < m; j++) CHECK(used[j] <= mentors->rows[j].capacity);
+    free(used);
+    return total;
+} // check_feasible_total
+
+/** @brief A (mentee, mentor) pair of the reference greedy, by its matrix index. */
+typedef struct {
+    int score;
+    int index;
+} ReferencePair;
+
+/** @brief Orders pairs from the highest score down, then in matrix order. */
+static int compare_reference_pairs(const void *a, const void *b) {
+    const ReferencePair *x = a, *y = b;
+    if (x->score != y->score) return x->score > y->score ? -1 : 1;
+    return (x->index > y->index) - (x->index < y->index);
+} // compare_reference_pairs
+
+/**
+ * @brief Reference greedy: sorts every pair from the highest score down, in row order.
+ *
+ * Leftover mentees take the first mentors with capacity left, like the bucketed engine.
+ */
+static void reference_greedy(const int *scores, int n, int m, int *capacity, int *matches) {
+    ReferencePair *pairs = malloc((size_t)n * m * sizeof(ReferencePair));
+    for (int k = 0; k < n * m; k++) pairs[k] = (ReferencePair){scores[k], k};
+    qsort(pairs, (size_t)n * m, sizeof(ReferencePair), compare_reference_pairs);
+    for (int i = 0; i < n; i++) matches[i] = -1;
+    for (int p = 0; p < n * m && pairs[p].score > 0; p++) {
+        int k = pairs[p].index;
+        if (matches[k / m] == -1 && capacity[k % m] > 0) {
+            matches[k / m] = k % m;
+            capacity[k % m]--;
+        }
+    }
+    free(pairs);
+    for (int i = 0, j = 0; i < n; i++) {
+        if (matches[i] != -1) continue;
+        while (j < m && capacity[j] <= 0) j++;
+        if (j == m) break;
+        matches[i] = j;
+        capacity[j]--;
+    }
+} // reference_greedy
+
+/**
+ * @brief Checks the bucketed engine against the reference greedy on random matrices.
+ *
+ * Wide score ranges stand in for weighted scores, so mentees are often requeued.
+ */
+static void test_bucketed_matches_reference(void) {
+    unsigned int state = 31;
+    BucketScratch scratch = {0};
+    for (int trial = 0; trial < 300; trial++) {
+        int n = 1 + test_random(&state) % 40;
+        int m = 1 + test_random(&state) % 12;
+        int range = 1 + test_random(&state) % (trial % 2 ? 60 : 4);
+        int *scores = malloc(n * m * sizeof(int));
+        int *capacity = malloc(m * sizeof(int));
+        int *expected_capacity = malloc(m * sizeof(int));
+        int *expected = malloc(n * sizeof(int));
+        int *matches = malloc(n * sizeof(int));
+        for (int k = 0; k < n * m; k++) scores[k] = test_random(&state) % range;
+        for (int j = 0; j < m; j++) capacity[j] = expected_capacity[j] = test_random(&state) % 4;
+
+        reference_greedy(scores, n, m, expected_capacity, expected);
+        CHECK(assign_by_score_buckets(scores, n, m, capacity, matches, &scratch, NULL));
+        CHECK(memcmp(matches, expected, n * sizeof(int)) == 0);
+        CHECK(memcmp(capacity, expected_capacity, m * sizeof(int)) == 0);
+
+        free(scores);
+        free(capacity);
+        free(expected_capacity);
+        free(expected);
+        free(matches);
+    }
+    free_bucket_scratch(&scratch);
+} // test_bucketed_matches_reference
+
+/**
+ * @brief Checks the bucketed engine when nearly every score is distinct.
+ *
+ * Weighted scores can make the number of score levels approach the number of pairs. A sweep
+ * that rescans every mentee per level takes seconds here; the heap finishes well within one.
+ */
+static void test_bucketed_handles_distinct_scores(void) {
+    unsigned int state = 43;
+    int n = 50000, m = 2;
+    int *scores = malloc((size_t)n * m * sizeof(int));
+    int *capacity = malloc(m * sizeof(int));
+    int *expected_capacity = malloc(m * sizeof(int));
+    int *expected = malloc(n * sizeof(int));
+    int *matches = malloc(n * sizeof(int));
+    for (int k = 0; k < n * m; k++) scores[k] = test_random(&state) % 1000000;
+    for (int j = 0; j < m; j++) capacity[j] = expected_capacity[j] = n / 2;
+
+    BucketScratch scratch = {0};
+    reference_greedy(scores, n, m, expected_capacity, expected);
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    CHECK(assign_by_score_buckets(scores, n, m, capacity, matches, &scratch, NULL));
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    CHECK(memcmp(matches, expected, n * sizeof(int)) == 0);
+    CHECK(memcmp(capacity, expected_capacity, m * sizeof(int)) == 0);
+    CHECK(elapsed < 1.0);
+
+    free_bucket_scratch(&scratch);
+    free(scores);
+    free(capacity);
+    free(expected_capacity);
+    free(expected);
+    free(matches);
+} // test_bucketed_handles_distinct_scores
+
+/**
+ * @brief Reference sequential engine: each mentee in row order takes its highest-scoring
+ * mentor with capacity left, the lowest index among ties.
+ */
+static void reference_sequential(const int *scores, int n, int m, int *capacity, int *matches) {
+    for (int i = 0; i < n; i++) {
+        matches[i] = -1;
+        for (int j = 0; j < m; j++) {
+            if (capacity[j] > 0 && (matches[i] == -1 || scores[i * m + j] > scores[i * m + matches[i]])) matches[i] = j;
+        }
+        if (matches[i] != -1) capacity[matches[i]]--;
+    }
+} // reference_sequential
+
+/**
+ * @brief Returns the mentor a mentee ranks at `rank`: higher score first, then lower index.
+ */
+static int ranked_mentor(const int *row, int m, int rank) {
+    for (int j = 0; j < m; j++) {
+        int above = 0;
+        for (int k = 0; k < m; k++) above += row[k] > row[j] || (row[k] == row[j] && k < j);
+        if (above == rank) return j;
+    }
+    return -1;
+} // ranked_mentor
+
+/**
+ * @brief Reference stable engine: textbook mentee-proposing deferred acceptance.
+ *
+ * Free mentees propose down their preferences one mentor at a time; a full mentor
+ * keeps the proposer only if it ranks above its worst held mentee. The mentee-optimal
+ * stable matching is unique, so every engine computing it must agree with this one.
+ */
+static void reference_stable(const int *scores, int n, int m, const int *capacity, int *matches) {
+    int *proposals = calloc(n, sizeof(int));
+    int *held = calloc(m, sizeof(int));
+    for (int i = 0; i < n; i++) matches[i] = -1;
+    bool proposed = true;
+    while (proposed) {
+        proposed = false;
+        for (int i = 0; i < n; i++) {
+            if (matches[i] != -1 || proposals[i] == m) continue;
+            int j = ranked_mentor(scores + i * m, m, proposals[i]++);
+            proposed = true;
+            if (capacity[j] <= 0) continue;
+            if (held[j] < capacity[j]) {
+                matches[i] = j;
+                held[j]++;
+                continue;
+            }
+            int worst = -1;
+            for (int k = 0; k < n; k++) {
+                if (matches[k] == j && (worst == -1 || scores[k * m + j] < scores[worst * m + j] ||
+                                        (scores[k * m + j] == scores[worst * m + j] && k > worst))) {
+                    worst = k;
+                }
+            }
+            if (scores[i * m + j] > scores[worst * m + j] || (scores[i * m + j] == scores[worst * m + j] && i < worst)) {
+                matches[worst] = -1;
+                matches[i] = j;
+            }
+        }
+    }
+    free(proposals);
+    free(held);
+} // reference_stable
+
+/**
+ * @brief A random instance and its score matrix.
+ */
+typedef struct {
+    int n;
+    int m;
+    DataSet *mentees;
+    DataSet *mentors;
+    int *scores;
+} Instance;
+
+/**
+ * @brief Makes an instance of up to `max_mentees` mentees and `max_mentors` mentors.
+ */
+static Instance make_instance(int min_mentees, int max_mentees, int min_mentors, int max_mentors, int attribute_pool,
+                              int max_capacity, unsigned int *state) {
+    Instance instance;
+    instance.n = min_mentees + test_random(state) % (max_mentees - min_mentees + 1);
+    instance.m = min_mentors + test_random(state) % (max_mentors - min_mentors + 1);
+    instance.mentees = make_random_dataset(instance.n, attribute_pool, 0, state);
+    instance.mentors = make_random_dataset(instance.m, attribute_pool, max_capacity, state);
+    instance.scores = NULL;
+    match_datasets(instance.mentees, instance.mentors, &instance.scores);
+    return instance;
+} // make_instance
+
+/** @brief Makes an instance small enough to solve exhaustively. */
+static Instance make_small_instance(unsigned int *state) {
+    return make_instance(1, 6, 1, 4, 6, 2, state);
+} // make_small_instance
+
+/** @brief Makes an instance large enough for parallel rounds and several stream batches. */
+static Instance make_large_instance(unsigned int *state) {
+    return make_instance(300, 499, 40, 99, TEST_ATTRIBUTE_COUNT, 3, state);
+} // make_large_instance
+
+static void free_instance(Instance *instance) {
+    free(instance->scores);
+    free_dataset(instance->mentees);
+    free_dataset(instance->mentors);
+} // free_instance
+
+/**
+ * @brief Copies the capacity of every mentor of an instance.
+ */
+static int *instance_capacities(const Instance *instance) {
+    int *capacity = malloc(instance->m * sizeof(int));
+    for (int j = 0; j < instance->m; j++) capacity[j] = instance->mentors->rows[j].capacity;
+    return capacity;
+} // instance_capacities
+
+/**
+ * @brief Checks that no mentee and mentor would both rather be matched to each other.
+ *
+ * Both sides rank by score with ties going to the lower index.
+ */
+static void check_stable(const int *matches, const int *scores, const DataSet *mentors, int n) {
+    int m = mentors->row_count;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) {
+            int current = matches[i];
+            if (mentors->rows[j].capacity <= 0 || current == j) continue;
+            if (current != -1 && (scores[i * m + j] < scores[i * m + current] ||
+                                  (scores[i * m + j] == scores[i * m + current] && j > current))) {
+                continue; // The mentee prefers its own mentor
+            }
+
+            // Mentor j must be full with mentees it ranks above i
+            int held = 0;
+            for (int k = 0; k < n; k++) {
+                if (matches[k] != j) continue;
+                held++;
+                CHECK(scores[k * m + j] > scores[i * m + j] || (scores[k * m + j] == scores[i * m + j] && k < i));
+            }
+            CHECK(held == mentors->rows[j].capacity);
+        }
+    }
+} // check_stable
+
+/**
+ * @brief Checks that two files have identical contents.
+ */
+static bool files_equal(const char *path1, const char *path2) {
+    FILE *file1 = fopen(path1, "r");
+    FILE *file2 = fopen(path2, "r");
+    bool equal = file1 && file2;
+    while (equal) {
+        int c1 = fgetc(file1);
+        int c2 = fgetc(file2);
+        equal = c1 == c2;
+        if (c1 == EOF) break;
+    }
+    if (file1) fclose(file1);
+    if (file2) fclose(file2);
+    return equal;
+} // files_equal
+
+/**
+ * @brief Streams the mentees from a CSV file and compares the result with the batch output.
+ */
+static void check_stream_file(DataSet *mentees, DataSet *mentors, int *sequential, const int *scores) {
+    FILE *input = fopen("mentees.csv", "w");
+    fprintf(input, "\n \r\nName,Attributes\n"); // Blank lines before the header do not replace it
+    for (int i = 0; i < mentees->row_count; i++) {
+        if (i == mentees->row_count / 2) fprintf(input, "\n"); // Blank lines are skipped
+        fprintf(input, "%s,", mentees->rows[i].name);
+        for (int a = 0; a < mentees->rows[i].attributes_count; a++) {
+            fprintf(input, "%s%s", a > 0 ? "|" : "", mentees->rows[i].attributes[a]);
+        }
+        fprintf(input, i + 1 < mentees->row_count ? "\n" : ""); // The last line has no newline
+    }
+    fclose(input);
+
+    StreamMatcher *matcher = stream_matcher_create(mentors, NULL, 3);
+    int fd = open("mentees.csv", O_RDONLY);
+    FILE *output = fopen("stream.csv", "w");
+    StreamReport report;
+    CHECK(matcher && fd >= 0 && output);
+    CHECK(stream_mentees(matcher, fd, false, output, NULL, &report));
+    fclose(output);
+    close(fd);
+    stream_matcher_destroy(matcher);
+
+    CHECK(write_output_file("output.csv", mentees, mentors, sequential, scores, false, NULL));
+    CHECK(files_equal("stream.csv", "output.csv"));
+    long assigned = 0;
+    for (int i = 0; i < mentees->row_count; i++) assigned += sequential[i] != -1;
+    CHECK(report.rows == mentees->row_count && report.assigned == assigned);
+    CHECK(report.p50_latency_ms <= report.p99_latency_ms && report.p99_latency_ms <= report.max_latency_ms);
+} // check_stream_file
+
+/**
+ * @brief Checks that a line too long to parse ends the stream after the rows before it,
+ * and that a followed input fails as soon as a line grows too long, without its newline.
+ */
+static void test_stream_rejects_long_line(void) {
+    unsigned int state = 11;
+    DataSet *mentors = make_random_dataset(3, 6, 3, &state);
+    FILE *input = fopen("long.csv", "w");
+    fprintf(input, "Name,Attributes\nFirst,%s\nSecond,%s\nLong,", TEST_ATTRIBUTES[0], TEST_ATTRIBUTES[1]);
+    for (int k = 0; k < MAX_LINE_LENGTH; k++) fputc('x', input);
+    fprintf(input, "\nAfter,%s\n", TEST_ATTRIBUTES[2]);
+    fclose(input);
+
+    StreamMatcher *matcher = stream_matcher_create(mentors, NULL, 2);
+    int fd = open("long.csv", O_RDONLY);
+    FILE *output = fopen("long_stream.csv", "w");
+    StreamReport report;
+    CHECK(matcher && fd >= 0 && output);
+    CHECK(!stream_mentees(matcher, fd, false, output, NULL, &report));
+    CHECK(report.rows == 2);
+    fclose(output);
+    close(fd);
+    stream_matcher_destroy(matcher);
+
+    // The writer keeps the pipe open, so only the length of the line can end the stream
+    int pipe_fds[2];
+    CHECK(pipe(pipe_fds) == 0);
+    char chunk[2 * MAX_LINE_LENGTH];
+    memset(chunk, 'x', sizeof(chunk));
+    int prefix = snprintf(chunk, sizeof(chunk), "Name,Attributes\nFirst,%s\nLong,", TEST_ATTRIBUTES[0]);
+    chunk[prefix] = 'x';
+    CHECK(write(pipe_fds[1], chunk, sizeof(chunk)) == (ssize_t)sizeof(chunk));
+    CancellationToken deadline;
+    init_cancellation_token(&deadline);
+    set_cancellation_deadline(&deadline, 10000);
+    matcher = stream_matcher_create(mentors, NULL, 2);
+    output = fopen("long_stream.csv", "w");
+    CHECK(!stream_mentees(matcher, pipe_fds[0], true, output, &deadline, &report));
+    CHECK(report.rows == 1 && !is_cancelled(&deadline));
+    fclose(output);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    stream_matcher_destroy(matcher);
+    free_dataset(mentors);
+} // test_stream_rejects_long_line
+
+/**
+ * @brief Checks every engine against the exhaustive optimum and an independent reference.
+ *
+ * The sequential and stable engines must reproduce their references exactly, since the
+ * optimum only bounds them from above.
+ */
+static void test_engines_against_optimum(void) {
+    unsigned int state = 7;
+    for (int trial = 0; trial < 200; trial++) {
+        Instance instance = make_small_instance(&state);
+        int n = instance.n, m = instance.m;
+        int *capacity = instance_capacities(&instance);
+        int optimum = brute_force_optimum(instance.scores, n, m, 0, capacity);
+        int *expected = malloc(n * sizeof(int));
+
+        int *sequential = NULL;
+        select_optimal_matches(instance.mentees, instance.mentors, instance.scores, &sequential);
+        CHECK(check_feasible_total(sequential, instance.scores, instance.mentors, n) <= optimum);
+        reference_sequential(instance.scores, n, m, capacity, expected);
+        CHECK(memcmp(sequential, expected, n * sizeof(int)) == 0);
+
+        int *bucketed = NULL;
+        select_bucketed_matches(instance.mentees, instance.mentors, instance.scores, &bucketed, NULL);
+        int bucketed_total = check_feasible_total(bucketed, instance.scores, instance.mentors, n);
+        CHECK(bucketed_total <= optimum);
+        CHECK(2 * bucketed_total >= optimum);
+
+        int *stable = NULL;
+        select_stable_matches(instance.mentees, instance.mentors, instance.scores, &stable, NULL);
+        CHECK(check_feasible_total(stable, instance.scores, instance.mentors, n) <= optimum);
+        check_stable(stable, instance.scores, instance.mentors, n);
+        free(capacity);
+        capacity = instance_capacities(&instance);
+        reference_stable(instance.scores, n, m, capacity, expected);
+        CHECK(memcmp(stable, expected, n * sizeof(int)) == 0);
+
+        free(capacity);
+        free(expected);
+        free(sequential);
+        free(bucketed);
+        free(stable);
+        free_instance(&instance);
+    }
+} // test_engines_against_optimum
+
+/**
+ * @brief Checks that every engine and local search reach the optimum when mentors never fill up.
+ *
+ * Without contention, each mentee taking its best mentor is optimal, so all of them are exact.
+ */
+static void test_engines_exact_without_contention(void) {
+    unsigned int state = 17;
+    for (int trial = 0; trial < 100; trial++) {
+        Instance instance = make_small_instance(&state);
+        int n = instance.n, m = instance.m;
+        for (int j = 0; j < m; j++) instance.mentors->rows[j].capacity = n;
+        int *capacity = instance_capacities(&instance);
+        int optimum = brute_force_optimum(instance.scores, n, m, 0, capacity);
+
+        int *matches = NULL;
+        select_optimal_matches(instance.mentees, instance.mentors, instance.scores, &matches);
+        CHECK(check_feasible_total(matches, instance.scores, instance.mentors, n) == optimum);
+        free(matches);
+        select_bucketed_matches(instance.mentees, instance.mentors, instance.scores, &matches, NULL);
+        CHECK(check_feasible_total(matches, instance.scores, instance.mentors, n) == optimum);
+        free(matches);
+        select_stable_matches(instance.mentees, instance.mentors, instance.scores, &matches, NULL);
+        CHECK(check_feasible_total(matches, instance.scores, instance.mentors, n) == optimum);
+
+        // Local search from an arbitrary start moves every mentee to its best mentor
+        for (int i = 0; i < n; i++) matches[i] = i % 2 ? -1 : i % m;
+        for (int j = 0; j < m; j++) capacity[j] = n;
+        for (int i = 0; i < n; i++) {
+            if (matches[i] != -1) capacity[matches[i]]--;
+        }
+        CHECK(improve_assignment(instance.scores, n, m, capacity, matches, NULL) == 1);
+        CHECK(check_feasible_total(matches, instance.scores, instance.mentors, n) == optimum);
+
+        free(matches);
+        free(capacity);
+        free_instance(&instance);
+    }
+} // test_engines_exact_without_contention
+
+/**
+ * @brief Checks that the library engines match the pipeline engines exactly, and that
+ * solves taking their buffers from an arena match the `malloc` ones.
+ */
+static void test_library_matches_pipeline(void) {
+    unsigned int state = 23;
+    PairingContext *context = pairing_create(2);
+    for (int trial = 0; trial < 100; trial++) {
+        Instance instance = make_small_instance(&state);
+        int n = instance.n;
+        int *library = malloc(n * sizeof(int));
+        int *pipeline = NULL;
+
+        select_optimal_matches(instance.mentees, instance.mentors, instance.scores, &pipeline);
+        pairing_set_solver(context, SOLVER_SEQUENTIAL);
+        CHECK(pairing_match(context, instance.mentees, instance.mentors, library, NULL));
+        CHECK(memcmp(library, pipeline, n * sizeof(int)) == 0);
+
+        // Arena-backed solves return the same matches, which the arena then owns
+        Arena arena;
+        init_arena(&arena, 64);
+        SolverOptions arena_options = {.arena = &arena};
+        int *from_arena = NULL;
+        select_optimal_matches_with_options(instance.mentees, instance.mentors, instance.scores, &from_arena,
+                                            &arena_options);
+        CHECK(memcmp(from_arena, pipeline, n * sizeof(int)) == 0);
+        free(pipeline);
+
+        select_bucketed_matches(instance.mentees, instance.mentors, instance.scores, &pipeline, NULL);
+        pairing_set_solver(context, SOLVER_BUCKETED);
+        CHECK(pairing_match(context, instance.mentees, instance.mentors, library, NULL));
+        CHECK(memcmp(library, pipeline, n * sizeof(int)) == 0);
+        select_bucketed_matches(instance.mentees, instance.mentors, instance.scores, &from_arena, &arena_options);
+        CHECK(memcmp(from_arena, pipeline, n * sizeof(int)) == 0);
+        free_arena(&arena);
+        free(pipeline);
+
+        select_stable_matches(instance.mentees, instance.mentors, instance.scores, &pipeline, NULL);
+        pairing_set_solver(context, SOLVER_STABLE);
+        CHECK(pairing_match(context, instance.mentees, instance.mentors, library, NULL));
+        CHECK(memcmp(library, pipeline, n * sizeof(int)) == 0);
+        free(pipeline);
+
+        free(library);
+        free_instance(&instance);
+    }
+    pairing_destroy(context);
+} // test_library_matches_pipeline
+
+/**
+ * @brief Checks that the stable engine gives the same matching with one thread or several.
+ *
+ * Large instances exercise the parallel rounds and preference window refills.
+ */
+static void test_stable_independent_of_threads(void) {
+    unsigned int state = 29;
+    ThreadPool *single = thread_pool_create(1);
+    ThreadPool *pool = thread_pool_create(4);
+    StableScratch scratch = {0};
+    for (int trial = 0; trial < 103; trial++) {
+        Instance instance = trial < 100 ? make_small_instance(&state) : make_large_instance(&state);
+        int n = instance.n;
+        int *capacity = instance_capacities(&instance);
+        int *parallel = malloc(n * sizeof(int));
+        int *serial = malloc(n * sizeof(int));
+        CHECK(assign_stable_matching(instance.scores, n, instance.m, capacity, parallel, pool, &scratch, NULL));
+        CHECK(assign_stable_matching(instance.scores, n, instance.m, capacity, serial, single, &scratch, NULL));
+        CHECK(memcmp(parallel, serial, n * sizeof(int)) == 0);
+        check_feasible_total(parallel, instance.scores, instance.mentors, n);
+        check_stable(parallel, instance.scores, instance.mentors, n);
+        free(capacity);
+        free(parallel);
+        free(serial);
+        free_instance(&instance);
+    }
+    free_stable_scratch(&scratch);
+    thread_pool_destroy(pool);
+    thread_pool_destroy(single);
+} // test_stable_independent_of_threads
+
+/**
+ * @brief Checks that the stable engine handles capacities far above the number of mentees.
+ *
+ * Memory does not grow with capacity, and with room everywhere each mentee gets its first choice.
+ */
+static void test_stable_huge_capacities(void) {
+    unsigned int state = 53;
+    ThreadPool *pool = thread_pool_create(2);
+    StableScratch scratch = {0};
+    for (int trial = 0; trial < 20; trial++) {
+        Instance instance = trial < 19 ? make_small_instance(&state) : make_large_instance(&state);
+        int n = instance.n, m = instance.m;
+        int *capacity = malloc(m * sizeof(int));
+        for (int j = 0; j < m; j++) capacity[j] = INT_MAX - j;
+        int *matches = malloc(n * sizeof(int));
+        CHECK(assign_stable_matching(instance.scores, n, m, capacity, matches, pool, &scratch, NULL));
+        for (int i = 0; i < n; i++) CHECK(matches[i] == ranked_mentor(instance.scores + i * m, m, 0));
+        free(capacity);
+        free(matches);
+        free_instance(&instance);
+    }
+    free_stable_scratch(&scratch);
+    thread_pool_destroy(pool);
+} // test_stable_huge_capacities
+
+/**
+ * @brief Checks that the output file reports the scores of the matrix it is given.
+ */
+static void test_output_reports_scores(void) {
+    unsigned int state = 31;
+    for (int trial = 0; trial < 50; trial++) {
+        Instance instance = make_small_instance(&state);
+        int *sequential = NULL;
+        select_optimal_matches(instance.mentees, instance.mentors, instance.scores, &sequential);
+        CHECK(write_output_file("output.csv", instance.mentees, instance.mentors, sequential, instance.scores, false,
+                                NULL));
+        FILE *output = fopen("output.csv", "r");
+        char line[256];
+        CHECK(output && fgets(line, sizeof(line), output));
+        for (int i = 0; output && i < instance.n && fgets(line, sizeof(line), output); i++) {
+            int expected = sequential[i] != -1 ? instance.scores[i * instance.m + sequential[i]] : 0;
+            CHECK(atoi(strrchr(line, ',') + 1) == expected);
+        }
+        if (output) fclose(output);
+        free(sequential);
+        free_instance(&instance);
+    }
+} // test_output_reports_scores
+
+/**
+ * @brief Checks that the stream matcher reproduces the sequential engine, in batches
+ * in memory and from a CSV file spanning several reads.
+ */
+static void test_stream_matches_sequential(void) {
+    unsigned int state = 37;
+    for (int trial = 0; trial < 103; trial++) {
+        Instance instance = trial < 100 ? make_small_instance(&state) : make_large_instance(&state);
+        int n = instance.n;
+        int *sequential = NULL;
+        select_optimal_matches(instance.mentees, instance.mentors, instance.scores, &sequential);
+        if (trial >= 100) {
+            check_stream_file(instance.mentees, instance.mentors, sequential, instance.scores);
+        }
+
+        // Streaming the mentees in two parts assigns them like the sequential engine
+        StreamMatcher *matcher = stream_matcher_create(instance.mentors, NULL, 2);
+        int *streamed = malloc(n * sizeof(int));
+        int *streamed_scores = malloc(n * sizeof(int));
+        CHECK(matcher && stream_matcher_assign(matcher, instance.mentees->rows, n / 2, streamed, streamed_scores));
+        CHECK(stream_matcher_assign(matcher, instance.mentees->rows + n / 2, n - n / 2, streamed + n / 2,
+                                    streamed_scores + n / 2));
+        CHECK(memcmp(streamed, sequential, n * sizeof(int)) == 0);
+        for (int i = 0; i < n; i++) {
+            CHECK(streamed_scores[i] == (sequential[i] != -1 ? instance.scores[i * instance.m + sequential[i]] : 0));
+        }
+        stream_matcher_destroy(matcher);
+        free(streamed);
+        free(streamed_scores);
+        free(sequential);
+        free_instance(&instance);
+    }
+} // test_stream_matches_sequential
+
+/**
+ * @brief Checks that weighted streaming assigns like the library with the same weights,
+ * including ignored attributes.
+ */
+static void test_weighted_stream_matches_library(void) {
+    unsigned int state = 41;
+    PairingContext *context = pairing_create(2);
+    for (int trial = 0; trial < 3; trial++) {
+        Instance instance = make_large_instance(&state);
+        int n = instance.n;
+        AttributeWeights weights;
+        init_attribute_weights(&weights);
+        CHECK(compute_idf_weights(&weights, instance.mentees, instance.mentors));
+        CHECK(set_attribute_weight(&weights, TEST_ATTRIBUTES[trial], 0));
+        int *library = malloc(n * sizeof(int));
+        int *library_scores = malloc(n * sizeof(int));
+        pairing_set_weights(context, &weights);
+        pairing_set_solver(context, SOLVER_SEQUENTIAL);
+        CHECK(pairing_match(context, instance.mentees, instance.mentors, library, library_scores));
+        pairing_set_weights(context, NULL);
+        StreamMatcher *matcher = stream_matcher_create(instance.mentors, &weights, 4);
+        free_attribute_weights(&weights);
+        int *streamed = malloc(n * sizeof(int));
+        int *streamed_scores = malloc(n * sizeof(int));
+        CHECK(matcher && stream_matcher_assign(matcher, instance.mentees->rows, n, streamed, streamed_scores));
+        CHECK(memcmp(streamed, library, n * sizeof(int)) == 0);
+        CHECK(memcmp(streamed_scores, library_scores, n * sizeof(int)) == 0);
+        stream_matcher_destroy(matcher);
+        free(streamed);
+        free(streamed_scores);
+        free(library);
+        free(library_scores);
+        free_instance(&instance);
+    }
+    pairing_destroy(context);
+} // test_weighted_stream_matches_library
+
+/**
+ * @brief Checks that local search keeps the assignment feasible, never lowers its score,
+ * and that the report measures it against the capacity-free bound.
+ */
+static void test_local_search_improves(void) {
+    unsigned int state = 43;
+    PairingContext *context = pairing_create(2);
+    for (int trial = 0; trial < 200; trial++) {
+        Instance instance = make_small_instance(&state);
+        int n = instance.n, m = instance.m;
+        int *capacity = instance_capacities(&instance);
+        int optimum = brute_force_optimum(instance.scores, n, m, 0, capacity);
+
+        int *improved = NULL;
+        select_optimal_matches(instance.mentees, instance.mentors, instance.scores, &improved);
+        int sequential_total = check_feasible_total(improved, instance.scores, instance.mentors, n);
+        for (int i = 0; i < n; i++) {
+            if (improved[i] != -1) capacity[improved[i]]--;
+        }
+        CHECK(improve_assignment(instance.scores, n, m, capacity, improved, NULL) == 1);
+        int improved_total = check_feasible_total(improved, instance.scores, instance.mentors, n);
+        CHECK(improved_total >= sequential_total && improved_total <= optimum);
+
+        SolverReport report;
+        evaluate_assignment(instance.scores, n, m, improved, &report);
+        CHECK(report.objective == improved_total && report.upper_bound >= optimum);
+        CHECK(report.gap >= 0.0 && report.gap <= 1.0);
+
+        // With time to spare, the library improves on the greedy result and reports it
+        CancellationToken deadline;
+        init_cancellation_token(&deadline);
+        set_cancellation_deadline(&deadline, 60000);
+        int *library = malloc(n * sizeof(int));
+        pairing_set_cancellation(context, &deadline);
+        pairing_set_solver(context, SOLVER_SEQUENTIAL);
+        CHECK(pairing_match(context, instance.mentees, instance.mentors, library, NULL));
+        CHECK(check_feasible_total(library, instance.scores, instance.mentors, n) == pairing_report(context)->objective);
+        CHECK(pairing_report(context)->objective == improved_total && pairing_report(context)->completed);
+        pairing_set_cancellation(context, NULL);
+
+        free(library);
+        free(improved);
+        free(capacity);
+        free_instance(&instance);
+    }
+    pairing_destroy(context);
+} // test_local_search_improves
+
+/**
+ * @brief Checks that a solve cancelled up front still returns a feasible assignment.
+ */
+static void test_cancelled_solves(void) {
+    unsigned int state = 47;
+    for (int trial = 0; trial < 100; trial++) {
+        Instance instance = make_small_instance(&state);
+        int n = instance.n;
+        CancellationToken cancel;
+        init_cancellation_token(&cancel);
+        request_cancellation(&cancel);
+        SolverReport report;
+        SolverOptions options = {.cancel = &cancel, .improve = true, .report = &report};
+
+        // The sequential engine has not assigned anyone yet
+        int *cancelled = NULL;
+        select_optimal_matches_with_options(instance.mentees, instance.mentors, instance.scores, &cancelled, &options);
+        for (int i = 0; i < n; i++) CHECK(cancelled[i] == -1);
+        CHECK(!report.completed && report.objective == 0);
+        free(cancelled);
+
+        select_bucketed_matches(instance.mentees, instance.mentors, instance.scores, &cancelled, &options);
+        CHECK(check_feasible_total(cancelled, instance.scores, instance.mentors, n) == report.objective);
+        CHECK(!report.completed);
+        free(cancelled);
+        free_instance(&instance);
+    }
+} // test_cancelled_solves
+
+int main(void) {
+    // The pipeline engines write their arrangement log to the working directory
+    char dir[] = "/tmp/test_solution_selector_XXXXXX";
+    if (!mkdtemp(dir) || chdir(dir) != 0) {
+        perror("Failed to create temporary directory");
+        return EXIT_FAILURE;
+    }
+
+    test_bucketed_matches_reference();
+    test_bucketed_handles_distinct_scores();
+    test_engines_against_optimum();
+    test_engines_exact_without_contention();
+    test_library_matches_pipeline();
+    test_stable_independent_of_threads();
+    test_stable_huge_capacities();
+    test_output_reports_scores();
+    test_stream_matches_sequential();
+    test_stream_rejects_long_line();
+    test_weighted_stream_matches_library();
+    test_local_search_improves();
+    test_cancelled_solves();
+
+    remove("arrangement_scores.log");
+    remove("output.csv");
+    remove("mentees.csv");
+    remove("stream.csv");
+    remove("long.csv");
+    remove("long_stream.csv");
+    if (chdir("/") == 0) rmdir(dir);
+    return test_summary("test_solution_selector");
+} // main
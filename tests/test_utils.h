@@ -0,0 +1,84 @@
+/**
+ * @file test_utils.h
+ * @brief Shared helpers for the test programs.
+ *
+ * Provides a non-fatal `CHECK` macro, a deterministic random number generator and
+ * builders for random in-memory datasets. Each test program includes this header
+ * once and returns `test_summary()` from `main`.
+ *
+ * Dependencies:
+ * - `input_parser.h`: Defines the `DataSet` and `DataRow` structures.
+ */
+#ifndef TEST_UTILS_H
+#define TEST_UTILS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "input_parser.h"
+
+static int test_failures = 0;
+static int test_checks = 0;
+
+// Records a failed check without aborting the test program
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        test_checks++;                                                               \
+        if (!(cond)) {                                                               \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            test_failures++;                                                         \
+        }                                                                            \
+    } while (0)
+
+static const char *TEST_ATTRIBUTES[] = {"AI", "ML", "Web", "Data", "Cloud", "Security",
+                                        "Design", "Finance", "Law", "Bio", "Math", "Art"};
+#define TEST_ATTRIBUTE_COUNT ((int)(sizeof(TEST_ATTRIBUTES) / sizeof(TEST_ATTRIBUTES[0])))
+
+/**
+ * @brief Deterministic xorshift generator so failures can be reproduced from the seed.
+ */
+static inline unsigned int test_random(unsigned int *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+} // test_random
+
+/**
+ * @brief Builds a random dataset that can be released with `free_dataset`.
+ *
+ * @param row_count Number of rows.
+ * @param attribute_pool Number of distinct attributes to draw from (at most `TEST_ATTRIBUTE_COUNT`).
+ * @param max_capacity Largest capacity assigned to a row (0 for no capacity).
+ * @param state Random generator state.
+ * @return Pointer to the dataset.
+ */
+static inline DataSet *make_random_dataset(int row_count, int attribute_pool, int max_capacity, unsigned int *state) {
+    DataSet *dataset = malloc(sizeof(DataSet));
+    dataset->row_count = row_count;
+    dataset->rows = calloc(row_count > 0 ? row_count : 1, sizeof(DataRow));
+
+    for (int i = 0; i < row_count; i++) {
+        DataRow *row = &dataset->rows[i];
+        char name[32];
+        snprintf(name, sizeof(name), "R%d", i);
+        row->name = strdup(name);
+        row->attributes_count = 1 + test_random(state) % 4;
+        row->attributes = malloc(row->attributes_count * sizeof(char *));
+        for (int a = 0; a < row->attributes_count; a++) {
+            row->attributes[a] = strdup(TEST_ATTRIBUTES[test_random(state) % attribute_pool]);
+        }
+        row->capacity = max_capacity > 0 ? (int)(test_random(state) % (max_capacity + 1)) : 0;
+    }
+    return dataset;
+} // make_random_dataset
+
+/**
+ * @brief Prints the totals and returns the process exit status.
+ */
+static inline int test_summary(const char *name) {
+    printf("%s: %d checks, %d failures\n", name, test_checks, test_failures);
+    return test_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+} // test_summary
+
+#endif // TEST_UTILS_H
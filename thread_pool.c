@@ -0,0 +1,175 @@
+/**
+ * @file thread_pool.c
+ * @brief Fixed-size pool of worker threads for parallel-for batches.
+ *
+ * Workers sleep on a condition variable until a batch is published, then claim
+ * task indices from a shared atomic counter until the batch is exhausted. The
+ * last worker to finish wakes the caller blocked in `thread_pool_run`.
+ *
+ * Dependencies:
+ * - `thread_pool.h`: Declares the interface for this functionality.
+ */
+#include "thread_pool.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+struct ThreadPool {
+    pthread_t *threads;
+    int num_threads;
+    pthread_mutex_t mutex;
+    pthread_cond_t work_ready;   // Signaled when a batch is published or on shutdown
+    pthread_cond_t work_done;    // Signaled when the last worker leaves a batch
+    unsigned long generation;    // Incremented for every published batch
+    int active_workers;          // Workers still running the current batch
+    int shutdown;
+    ThreadPoolTask task;
+    void *arg;
+    int num_tasks;
+    atomic_int next_task;        // Next unclaimed task index
+};
+
+/**
+ * @brief Arguments handed to each worker thread at creation.
+ */
+typedef struct {
+    ThreadPool *pool;
+    int worker_index;
+} WorkerArgs;
+
+/**
+ * @brief Main loop of a worker thread.
+ */
+static void *worker_main(void *args) {
+    WorkerArgs *worker_args = args;
+    ThreadPool *pool = worker_args->pool;
+    int worker_index = worker_args->worker_index;
+    free(worker_args);
+
+    unsigned long seen_generation = 0;
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (!pool->shutdown && pool->generation == seen_generation) {
+            pthread_cond_wait(&pool->work_ready, &pool->mutex);
+        }
+        if (pool->shutdown) break;
+        seen_generation = pool->generation;
+        pthread_mutex_unlock(&pool->mutex);
+
+        // Claim tasks until the batch is exhausted
+        int task_index;
+        while ((task_index = atomic_fetch_add(&pool->next_task, 1)) < pool->num_tasks) {
+            pool->task(pool->arg, task_index, worker_index);
+        }
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->active_workers == 0) {
+            pthread_cond_signal(&pool->work_done);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+} // worker_main
+
+/**
+ * @brief Creates a pool with a fixed number of worker threads.
+ *
+ * @param num_threads Number of worker threads (at least 1).
+ * @return Pointer to the pool, or NULL on failure.
+ */
+ThreadPool *thread_pool_create(int num_threads) {
+    if (num_threads < 1) num_threads = 1;
+
+    ThreadPool *pool = calloc(1, sizeof(ThreadPool));
+    if (!pool) {
+        perror("Failed to allocate memory for thread pool");
+        return NULL;
+    }
+    pool->threads = malloc(num_threads * sizeof(pthread_t));
+    if (!pool->threads) {
+        perror("Failed to allocate memory for thread pool");
+        free(pool);
+        return NULL;
+    }
+
+    init_mutex(&pool->mutex);
+    pthread_cond_init(&pool->work_ready, NULL);
+    pthread_cond_init(&pool->work_done, NULL);
+    atomic_init(&pool->next_task, 0);
+
+    for (int i = 0; i < num_threads; i++) {
+        WorkerArgs *worker_args = malloc(sizeof(WorkerArgs));
+        if (worker_args) *worker_args = (WorkerArgs){.pool = pool, .worker_index = i};
+        if (!worker_args || pthread_create(&pool->threads[i], NULL, worker_main, worker_args) != 0) {
+            fprintf(stderr, "Error creating thread pool worker %d\n", i);
+            free(worker_args);
+            break;
+        }
+        pool->num_threads++;
+    }
+
+    if (pool->num_threads == 0) {
+        thread_pool_destroy(pool);
+        return NULL;
+    }
+    return pool;
+} // thread_pool_create
+
+/**
+ * @brief Returns the number of worker threads in the pool.
+ */
+int thread_pool_size(const ThreadPool *pool) {
+    return pool->num_threads;
+} // thread_pool_size
+
+/**
+ * @brief Runs a batch of tasks on the pool and waits for it to complete.
+ *
+ * @param pool Pointer to the pool.
+ * @param task Function executed once per task index.
+ * @param arg Argument passed to every invocation of `task`.
+ * @param num_tasks Number of tasks in the batch.
+ */
+void thread_pool_run(ThreadPool *pool, ThreadPoolTask task, void *arg, int num_tasks) {
+    if (num_tasks <= 0) return;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->task = task;
+    pool->arg = arg;
+    pool->num_tasks = num_tasks;
+    atomic_store(&pool->next_task, 0);
+    pool->active_workers = pool->num_threads;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work_ready);
+
+    while (pool->active_workers > 0) {
+        pthread_cond_wait(&pool->work_done, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+} // thread_pool_run
+
+/**
+ * @brief Stops the worker threads and frees the pool.
+ *
+ * @param pool Pointer to the pool to be destroyed.
+ */
+void thread_pool_destroy(ThreadPool *pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int i = 0; i < pool->num_threads; i++) {
+        if (pthread_join(pool->threads[i], NULL) != 0) {
+            fprintf(stderr, "Error joining thread pool worker %d\n", i);
+        }
+    }
+
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_cond_destroy(&pool->work_done);
+    destroy_mutex(&pool->mutex);
+    free(pool->threads);
+    free(pool);
+} // thread_pool_destroy
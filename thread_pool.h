@@ -0,0 +1,40 @@
+/**
+ * @file thread_pool.h
+ * @brief Header file for the fixed-size worker thread pool.
+ *
+ * Declares a pool of long-lived worker threads that execute parallel-for style
+ * batches of tasks, so repeated parallel phases do not pay for thread creation.
+ *
+ * Dependencies:
+ * - `synchronization.h`: Provides the mutex helpers used by the pool.
+ *
+ * Notes:
+ * - `thread_pool_run` blocks until every task of the batch has completed.
+ * - Only one batch may run on a pool at a time.
+ */
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include "synchronization.h"
+
+/**
+ * @brief Opaque handle to a thread pool.
+ */
+typedef struct ThreadPool ThreadPool;
+
+/**
+ * @brief Function executed for each task of a batch.
+ *
+ * @param arg Batch argument passed to `thread_pool_run`.
+ * @param task_index Index of the task within the batch.
+ * @param worker_index Index of the worker running the task (0 to size - 1).
+ */
+typedef void (*ThreadPoolTask)(void *arg, int task_index, int worker_index);
+
+// Function Declarations
+ThreadPool *thread_pool_create(int num_threads);
+int thread_pool_size(const ThreadPool *pool);
+void thread_pool_run(ThreadPool *pool, ThreadPoolTask task, void *arg, int num_tasks);
+void thread_pool_destroy(ThreadPool *pool);
+
+#endif // THREAD_POOL_H